@@ -0,0 +1,710 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Archive.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Writes process files in a compact binary form split in
+ *          blocks, and reads them back decoding the blocks in parallel.
+ *
+ * References:
+ *          Variable length integers as in LEB128 and the zig zag
+ *          encoding of signed values used by protocol buffers.
+ *
+ * Error handling:
+ *          If a file can not be created or written, or a block is
+ *          damaged, an error message is printed. DestroyArchiveWriter
+ *          returns EXIT_FAILURE if any write failed. A block cut short, or whose counts
+ *          and sizes can not be right, ends the file, a damaged one
+ *          loses the processes after the damage. ArchiveFailed tells
+ *          if that happened once the file has been read.
+ *
+ * Notes:
+ *          The file starts with the magic "SCHT", the version, the flags
+ *          and the quantum as 32 bit integers in the byte order of the
+ *          machine. Then come blocks of about BLOCK_BYTES bytes: the
+ *          number of processes, the size of the encoded processes and
+ *          the size stored, followed by the stored bytes.
+ *
+ *          Each process is written as variable length integers: the ID
+ *          and the arrival as differences with the previous process of
+ *          the block, the priority, the relative deadline plus one or 0
+ *          for none, the group, the number of bursts or 0 for a single
+ *          one, and the bursts. Signed values are zig zag encoded. A
+ *          process of a sorted file usually takes a few bytes. Blocks
+ *          do not depend on each other, so when the program is built
+ *          with HAVE_ZLIB they can also be compressed with zlib.
+ *
+ *          A set of threads reads the blocks in turn and decodes them
+ *          at the same time, leaving them in slots indexed by their
+ *          number. The processes are handed in the order of the file.
+ *          Threads never read more than two blocks per thread ahead of
+ *          the block being handed, so the memory does not depend on the
+ *          size of the file.
+ *
+ */
+#include <stdio.h>      /* Used for fread and fwrite */
+#include <stdlib.h>     /* Used for memory manipulation */
+#include <string.h>     /* Used for memcmp and memcpy */
+#include <limits.h>     /* Used for LONG_MAX */
+#include <glib.h>       /* Used for GThread, GMutex and GCond */
+#ifdef HAVE_ZLIB
+#include <zlib.h>       /* Used to compress the blocks */
+#endif
+#include "FileIO.h"     /* Used for ErrorMsg */
+#include "Process.h"    /* Used for the data structures */
+#include "Archive.h"    /* Function header */
+
+#define VERSION 1               //!< Version of the format.
+#define FLAG_ZLIB 1             //!< Flag of the blocks compressed with zlib.
+#define HEADER_VALUES 4         //!< Magic, version, flags and quantum.
+#define BLOCK_VALUES 3          //!< Processes, encoded size and stored size of a block.
+#define BLOCK_BYTES (1 << 20)   //!< Encoded size after which a block is written.
+#define MAX_VARINT 5            //!< Longest encoding of a 32 bit value.
+#define FIXED_VALUES 7          //!< Values of a process besides its list of bursts.
+#define SLOTS_PER_THREAD 2      //!< Blocks decoded ahead per thread.
+#define MAX_RATIO 1032          //!< Highest compression ratio of zlib.
+
+/* Declaration of the data structure archive_writer_p with the block being filled */
+struct archive_writer_p
+{
+    FILE *fp;             /* File being written */
+    int compress;         /* 1 to compress the blocks with zlib */
+    unsigned char *raw;   /* Encoded processes of the block */
+    long size;            /* Bytes used in raw */
+    long capacity;        /* Size of raw */
+    int count;            /* Processes in the block */
+    int lastId;           /* ID of the previous process of the block */
+    int lastArrival;      /* Arrival of the previous process of the block */
+    int error;            /* 1 once a write failed */
+};
+
+/* Declaration of the data structure slot_p with a decoded block */
+struct slot_p
+{
+    Process *processes; /* Processes of the block in order */
+    int count;          /* Number of processes */
+    int ready;          /* 1 once the block is decoded and not yet taken */
+};
+
+/* Declaration of the data structure archive_p with the readers and the decoded blocks */
+struct archive_p
+{
+    FILE *fp;              /* File being read */
+    int quantum;           /* Quantum of the file */
+    int flags;             /* Flags of the file */
+    GThread **threads;     /* Threads that read and decode the blocks */
+    int nthreads;          /* Number of threads */
+    struct slot_p *slots;  /* Decoded blocks by number modulo nslots */
+    int nslots;            /* Number of slots */
+    long nextRead;         /* Number of the next block to read, protected by read */
+    long remaining;        /* Bytes of the file not read yet, protected by read */
+    long nextHand;         /* Number of the next block to hand */
+    long total;            /* Number of blocks, -1 until the end is read */
+    int done;              /* 1 when the threads must stop */
+    int failed;            /* 1 if a block was damaged or cut short */
+    GMutex read;           /* Serialises the reads of the file */
+    GMutex lock;           /* Protects the slots, nextHand, total, done and failed */
+    GCond cond;            /* Signals changes of the slots and of nextHand */
+    Process *current;      /* Block being handed */
+    int position;          /* Next process of current */
+    int count;             /* Processes in current */
+};
+
+/*!
+* Writes a value as a variable length integer.
+*
+* Receive param p Where the value is written, needs MAX_VARINT bytes
+* Receive param value The value
+*
+* return Number of bytes written
+*/
+static int putVarint(unsigned char *p, unsigned int value)
+{
+    int length = 0;
+    while (value >= 0x80)
+    {
+        p[length++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    p[length++] = (unsigned char)value;
+    return length;
+}
+
+/*!
+* Maps a signed value to an unsigned one so small magnitudes are short,
+* 0, -1, 1, -2 become 0, 1, 2, 3.
+*
+* Receive param value The value
+*
+* return The zig zag encoded value
+*/
+static unsigned int zigZag(int value)
+{
+    return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+}
+
+/*!
+* Undoes zigZag.
+*
+* Receive param encoded The zig zag encoded value
+*
+* return The signed value
+*/
+static int unZigZag(unsigned int encoded)
+{
+    return (int)(encoded >> 1) ^ -(int)(encoded & 1);
+}
+
+/*!
+* Writes a signed value zig zag encoded.
+*
+* Receive param p Where the value is written, needs MAX_VARINT bytes
+* Receive param value The value
+*
+* return Number of bytes written
+*/
+static int putSigned(unsigned char *p, int value)
+{
+    return putVarint(p, zigZag(value));
+}
+
+/*!
+* Reads a variable length integer.
+*
+* Receive param p Pointer to the position, moved after the value
+* Receive param end End of the encoded bytes
+* Receive param value Where the value is written
+*
+* return 1 if the value was read, 0 if the bytes end before it does
+*/
+static int getVarint(const unsigned char **p, const unsigned char *end, unsigned int *value)
+{
+    unsigned int result = 0;
+    int shift;
+    for (shift = 0; shift < 7 * MAX_VARINT && *p < end; shift += 7)
+    {
+        result |= (unsigned int)(**p & 0x7f) << shift;
+        if ((*(*p)++ & 0x80) == 0)
+        {
+            *value = result;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*!
+* Reads a zig zag encoded signed value.
+*
+* Receive param p Pointer to the position, moved after the value
+* Receive param end End of the encoded bytes
+* Receive param value Where the value is written
+*
+* return 1 if the value was read
+*/
+static int getSigned(const unsigned char **p, const unsigned char *end, int *value)
+{
+    unsigned int encoded;
+    if (!getVarint(p, end, &encoded))
+        return 0;
+    *value = unZigZag(encoded);
+    return 1;
+}
+
+/*!
+* Creates a compressed process file.
+*
+* Receive param filename Name of the file
+* Receive param quantum Quantum stored in the file
+* Receive param compress 1 to compress the blocks with zlib
+*
+* return Pointer to the writer or NULL on error
+*/
+ArchiveWriter CreateArchiveWriter(const char *filename, int quantum, int compress)
+{
+    ArchiveWriter writer;
+    FILE *fp;
+    int header[HEADER_VALUES] = {0, VERSION, 0, quantum};
+#ifndef HAVE_ZLIB
+    if (compress)
+    {
+        ErrorMsg("CreateArchiveWriter", "built without zlib, blocks can not be compressed");
+        return NULL;
+    }
+#endif
+    fp = fopen(filename, "wb");
+    if (fp == NULL)
+    {
+        ErrorMsg("CreateArchiveWriter", "archive could not be created");
+        return NULL;
+    }
+    memcpy(header, "SCHT", 4);
+    header[2] = compress ? FLAG_ZLIB : 0;
+    writer = (ArchiveWriter)calloc(1, sizeof(struct archive_writer_p));
+    writer->fp = fp;
+    writer->error = (fwrite(header, sizeof(int), HEADER_VALUES, fp) != HEADER_VALUES);
+    writer->compress = compress;
+    writer->capacity = BLOCK_BYTES;
+    writer->raw = (unsigned char *)malloc(writer->capacity);
+    return writer;
+}
+
+/*!
+* Writes the block being filled and starts a new one.
+*
+* Receive param writer The writer
+*/
+static void flushBlock(ArchiveWriter writer)
+{
+    unsigned int values[BLOCK_VALUES];
+    unsigned char *stored = writer->raw;
+#ifdef HAVE_ZLIB
+    uLongf packed = 0;
+#endif
+    values[0] = (unsigned int)writer->count;
+    values[1] = (unsigned int)writer->size;
+    values[2] = (unsigned int)writer->size;
+#ifdef HAVE_ZLIB
+    if (writer->compress)
+    {
+        packed = compressBound(writer->size);
+        stored = (unsigned char *)malloc(packed);
+        if (stored == NULL || compress2(stored, &packed, writer->raw, writer->size, Z_DEFAULT_COMPRESSION) != Z_OK)
+            writer->error = 1;
+        values[2] = (unsigned int)packed;
+    }
+#endif
+    if (!writer->error && (fwrite(values, sizeof(int), BLOCK_VALUES, writer->fp) != BLOCK_VALUES ||
+                           fwrite(stored, 1, values[2], writer->fp) != values[2]))
+        writer->error = 1;
+    if (stored != writer->raw)
+        free(stored);
+    writer->size = 0;
+    writer->count = 0;
+    writer->lastId = 0;
+    writer->lastArrival = 0;
+}
+
+/*!
+* Adds a process to the file.
+*
+* Receive param writer The writer
+* Receive param process The process, it is not changed
+*/
+void ArchiveWrite(ArchiveWriter writer, Process process)
+{
+    long needed = (FIXED_VALUES + process->process_nbursts) * MAX_VARINT;
+    unsigned char *p;
+    int i;
+    if (writer->count > 0 && writer->size + needed > BLOCK_BYTES)
+        flushBlock(writer);
+    if (writer->size + needed > writer->capacity)
+    {
+        writer->capacity = writer->size + needed;
+        writer->raw = (unsigned char *)realloc(writer->raw, writer->capacity);
+    }
+    p = writer->raw + writer->size;
+    p += putSigned(p, process->process_id - writer->lastId);
+    p += putSigned(p, process->process_arrival - writer->lastArrival);
+    p += putSigned(p, process->process_priority);
+    if (process->process_deadline == NO_DEADLINE)
+        p += putVarint(p, 0);
+    else
+        p += putVarint(p, zigZag(process->process_deadline - process->process_arrival) + 1);
+    p += putSigned(p, process->process_group);
+    p += putVarint(p, (unsigned int)process->process_nbursts);
+    if (process->process_bursts == NULL)
+        p += putSigned(p, process->process_burst);
+    for (i = 0; i < process->process_nbursts; i++)
+        p += putSigned(p, process->process_bursts[i]);
+    writer->size = p - writer->raw;
+    writer->count++;
+    writer->lastId = process->process_id;
+    writer->lastArrival = process->process_arrival;
+}
+
+/*!
+* Writes the last block and closes the file.
+*
+* Receive param writer The writer to destroy
+*
+* return EXIT_SUCCESS or EXIT_FAILURE if some part of the file could not be written
+*/
+int DestroyArchiveWriter(ArchiveWriter writer)
+{
+    int status;
+    if (writer->count > 0)
+        flushBlock(writer);
+    if (fclose(writer->fp) != 0)
+        writer->error = 1;
+    if (writer->error)
+        ErrorMsg("DestroyArchiveWriter", "archive could not be written");
+    status = writer->error ? EXIT_FAILURE : EXIT_SUCCESS;
+    free(writer->raw);
+    free(writer);
+    return status;
+}
+
+/*!
+* Tells if a file is a compressed process file, the file is left at its
+* start.
+*
+* Receive param fp The file
+*
+* return 1 if it starts with the magic of the format
+*/
+int IsArchive(FILE *fp)
+{
+    char magic[4];
+    int found = fread(magic, 1, 4, fp) == 4 && memcmp(magic, "SCHT", 4) == 0;
+    rewind(fp);
+    return found;
+}
+
+/*!
+* Decodes the processes of a block.
+*
+* Receive param raw The encoded processes
+* Receive param size Bytes of raw
+* Receive param processes Where the processes are written
+* Receive param count Number of processes in the block
+*
+* return Number of processes decoded, less than count if the block is damaged
+*/
+static int decodeBlock(const unsigned char *raw, long size, Process *processes, int count)
+{
+    const unsigned char *p = raw, *end = raw + size;
+    unsigned int deadline, nbursts;
+    int id = 0, arrival = 0, priority, group, delta, burst, n, i;
+    Process process;
+    for (n = 0; n < count; n++)
+    {
+        if (!getSigned(&p, end, &delta))
+            break;
+        id += delta;
+        if (!getSigned(&p, end, &delta) || !getSigned(&p, end, &priority) || !getVarint(&p, end, &deadline) ||
+            !getSigned(&p, end, &group) || !getVarint(&p, end, &nbursts) || (long)nbursts > end - p)
+            break;
+        arrival += delta;
+        /* Like ReadProcess, time can not go backwards */
+        if (arrival < 0)
+            break;
+        process = NewProcess(id, arrival, 0, priority);
+        if (deadline > 0)
+            process->process_deadline = arrival + unZigZag(deadline - 1);
+        process->process_group = group;
+        if (nbursts == 0)
+        {
+            if (!getSigned(&p, end, &process->process_burst) || process->process_burst < 0)
+            {
+                freeNode(process);
+                break;
+            }
+        }
+        else
+        {
+            process->process_nbursts = (int)nbursts;
+            process->process_bursts = (int *)malloc(nbursts * sizeof(int));
+            if (process->process_bursts == NULL)
+            {
+                freeNode(process);
+                break;
+            }
+            for (i = 0; i < (int)nbursts && getSigned(&p, end, &burst) && burst >= 0; i++)
+            {
+                process->process_bursts[i] = burst;
+                if (i % 2 == 0)
+                    process->process_burst += burst;
+                else
+                    process->process_iotime += burst;
+            }
+            if (i < (int)nbursts)
+            {
+                freeNode(process);
+                break;
+            }
+        }
+        process->process_remainingcycles = process->process_burst;
+        processes[n] = process;
+    }
+    return n;
+}
+
+/*!
+* Tells if the header of a block can be right.
+*
+* Receive param archive The archive
+* Receive param values Processes, encoded size and stored size of the block
+*
+* return 1 if the stored bytes fit in the rest of the file and the
+*        processes fit in the encoded size
+*
+* Every process takes at least one byte per value, and without zlib the
+  encoded and stored sizes are the same. This keeps a damaged header
+  from asking for more memory than the file can fill.
+*/
+static int validBlock(Archive archive, unsigned int *values)
+{
+    if ((long)values[2] > archive->remaining)
+        return 0;
+    if (values[0] > values[1] / FIXED_VALUES)
+        return 0;
+    if (archive->flags & FLAG_ZLIB)
+        return values[1] / MAX_RATIO <= values[2];
+    return values[1] == values[2];
+}
+
+/*!
+* Body of the threads, reads the next block, decodes it and leaves it in
+* its slot, until the file ends.
+*
+* Receive param data The archive
+*
+* return NULL
+*/
+static gpointer blockThread(gpointer data)
+{
+    Archive archive = data;
+    unsigned int values[BLOCK_VALUES];
+    unsigned char *stored, *raw;
+    struct slot_p *slot;
+    Process *processes;
+    long number;
+    size_t got;
+    int count;
+#ifdef HAVE_ZLIB
+    uLongf size;
+#endif
+    while (1)
+    {
+        g_mutex_lock(&archive->read);
+        /* Wait until the slot of the next block is free */
+        g_mutex_lock(&archive->lock);
+        while (!archive->done && archive->total < 0 && archive->nextRead >= archive->nextHand + archive->nslots)
+            g_cond_wait(&archive->cond, &archive->lock);
+        if (archive->done || archive->total >= 0)
+        {
+            g_mutex_unlock(&archive->lock);
+            g_mutex_unlock(&archive->read);
+            break;
+        }
+        g_mutex_unlock(&archive->lock);
+        number = archive->nextRead;
+        stored = NULL;
+        got = fread(values, sizeof(int), BLOCK_VALUES, archive->fp);
+        /* Only a file that ends right before a block ends correctly */
+        if (got != BLOCK_VALUES && (got > 0 || ferror(archive->fp)))
+            ErrorMsg("ArchiveNext", "block is cut short");
+        if (got == BLOCK_VALUES)
+        {
+            archive->remaining -= BLOCK_VALUES * sizeof(int);
+            if (!validBlock(archive, values) ||
+                (stored = (unsigned char *)malloc(values[2] > 0 ? values[2] : 1)) == NULL)
+            {
+                ErrorMsg("ArchiveNext", "block is damaged");
+            }
+            else if (fread(stored, 1, values[2], archive->fp) != values[2])
+            {
+                ErrorMsg("ArchiveNext", "block is cut short");
+                free(stored);
+                stored = NULL;
+            }
+            else
+            {
+                archive->remaining -= values[2];
+            }
+        }
+        if (stored == NULL)
+        {
+            g_mutex_lock(&archive->lock);
+            archive->total = number;
+            if (got > 0 || ferror(archive->fp))
+                archive->failed = 1;
+            g_cond_broadcast(&archive->cond);
+            g_mutex_unlock(&archive->lock);
+            g_mutex_unlock(&archive->read);
+            break;
+        }
+        archive->nextRead++;
+        g_mutex_unlock(&archive->read);
+
+        /* The block is decoded while the other threads read and decode theirs */
+        raw = stored;
+#ifdef HAVE_ZLIB
+        if (archive->flags & FLAG_ZLIB)
+        {
+            size = values[1];
+            raw = (unsigned char *)malloc(values[1] > 0 ? values[1] : 1);
+            if (raw == NULL || uncompress(raw, &size, stored, values[2]) != Z_OK || size != values[1])
+                values[1] = 0;
+            free(stored);
+        }
+#endif
+        processes = (Process *)malloc((values[0] > 0 ? values[0] : 1) * sizeof(Process));
+        count = (processes != NULL && raw != NULL) ? decodeBlock(raw, values[1], processes, (int)values[0]) : 0;
+        free(raw);
+        if (count < (int)values[0])
+            ErrorMsg("ArchiveNext", "block is damaged");
+
+        g_mutex_lock(&archive->lock);
+        slot = &archive->slots[number % archive->nslots];
+        slot->processes = processes;
+        slot->count = count;
+        slot->ready = 1;
+        if (count < (int)values[0])
+            archive->failed = 1;
+        g_cond_broadcast(&archive->cond);
+        g_mutex_unlock(&archive->lock);
+    }
+    return NULL;
+}
+
+/*!
+* Opens a compressed process file and starts decoding its blocks.
+*
+* Receive param fp The file, at its start
+*
+* return Pointer to the archive or NULL if the file can not be read
+*/
+Archive OpenArchive(FILE *fp)
+{
+    Archive archive;
+    int header[HEADER_VALUES];
+    long start, size;
+    int i;
+    if (fread(header, sizeof(int), HEADER_VALUES, fp) != HEADER_VALUES || memcmp(header, "SCHT", 4) != 0 ||
+        header[1] != VERSION)
+    {
+        ErrorMsg("OpenArchive", "not an archive of this version");
+        return NULL;
+    }
+#ifndef HAVE_ZLIB
+    if (header[2] & FLAG_ZLIB)
+    {
+        ErrorMsg("OpenArchive", "archive is compressed and the program was built without zlib");
+        return NULL;
+    }
+#endif
+    archive = (Archive)calloc(1, sizeof(struct archive_p));
+    archive->fp = fp;
+    archive->flags = header[2];
+    archive->quantum = header[3];
+    archive->total = -1;
+    /* The size of the file bounds the size of the blocks, unless it can not be seeked */
+    archive->remaining = LONG_MAX;
+    if ((start = ftell(fp)) >= 0 && fseek(fp, 0, SEEK_END) == 0 && (size = ftell(fp)) >= start)
+        archive->remaining = size - start;
+    fseek(fp, start, SEEK_SET);
+    archive->nthreads = (int)g_get_num_processors();
+    if (archive->nthreads < 1)
+        archive->nthreads = 1;
+    archive->nslots = SLOTS_PER_THREAD * archive->nthreads;
+    archive->slots = (struct slot_p *)calloc(archive->nslots, sizeof(struct slot_p));
+    g_mutex_init(&archive->read);
+    g_mutex_init(&archive->lock);
+    g_cond_init(&archive->cond);
+    archive->threads = (GThread **)malloc(archive->nthreads * sizeof(GThread *));
+    for (i = 0; i < archive->nthreads; i++)
+        archive->threads[i] = g_thread_new("archive", blockThread, archive);
+    return archive;
+}
+
+/*!
+* Returns the quantum stored in a compressed process file.
+*
+* Receive param archive The archive
+*
+* return The quantum
+*/
+int ArchiveQuantum(Archive archive)
+{
+    return archive->quantum;
+}
+
+/*!
+* Tells if part of a compressed process file could not be read.
+*
+* Receive param archive The archive, after ArchiveNext returned NULL
+*
+* return 1 if a block was damaged or cut short, 0 otherwise
+*/
+int ArchiveFailed(Archive archive)
+{
+    int failed;
+    g_mutex_lock(&archive->lock);
+    failed = archive->failed;
+    g_mutex_unlock(&archive->lock);
+    return failed;
+}
+
+/*!
+* Hands the next process of the file.
+*
+* Receive param archive The archive, as a gpointer so it can be used as a ProcessSource
+*
+* return The next process in the order of the file or NULL at its end
+*/
+Process ArchiveNext(gpointer archive)
+{
+    Archive a = archive;
+    struct slot_p *slot;
+    while (a->position == a->count)
+    {
+        free(a->current);
+        a->current = NULL;
+        a->position = 0;
+        a->count = 0;
+        g_mutex_lock(&a->lock);
+        slot = &a->slots[a->nextHand % a->nslots];
+        while (!slot->ready && (a->total < 0 || a->nextHand < a->total))
+            g_cond_wait(&a->cond, &a->lock);
+        if (!slot->ready)
+        {
+            g_mutex_unlock(&a->lock);
+            return NULL;
+        }
+        /* Taking the block frees its slot for a block further ahead */
+        a->current = slot->processes;
+        a->count = slot->count;
+        slot->processes = NULL;
+        slot->ready = 0;
+        a->nextHand++;
+        g_cond_broadcast(&a->cond);
+        g_mutex_unlock(&a->lock);
+    }
+    return a->current[a->position++];
+}
+
+/*!
+* Stops the threads and frees the memory of an archive, the file is not
+* closed.
+*
+* Receive param archive The archive to destroy
+*/
+void DestroyArchive(Archive archive)
+{
+    int i;
+    g_mutex_lock(&archive->lock);
+    archive->done = 1;
+    g_cond_broadcast(&archive->cond);
+    g_mutex_unlock(&archive->lock);
+    for (i = 0; i < archive->nthreads; i++)
+        g_thread_join(archive->threads[i]);
+    for (i = 0; i < archive->nslots; i++)
+    {
+        while (archive->slots[i].count > 0 && archive->slots[i].processes != NULL)
+            freeNode(archive->slots[i].processes[--archive->slots[i].count]);
+        free(archive->slots[i].processes);
+    }
+    while (archive->position < archive->count)
+        freeNode(archive->current[archive->position++]);
+    free(archive->current);
+    free(archive->slots);
+    free(archive->threads);
+    g_mutex_clear(&archive->read);
+    g_mutex_clear(&archive->lock);
+    g_cond_clear(&archive->cond);
+    free(archive);
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Archive.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the compressed process files
+ *
+ * Notes:
+ *          Requires glib.h, stdio.h and Process.h to be included first.
+ *
+ */
+
+/* We make a typedef to facilitate declaration of archive_writer_p structures */
+typedef struct archive_writer_p *ArchiveWriter;
+
+/* We make a typedef to facilitate declaration of archive_p structures */
+typedef struct archive_p *Archive;
+
+/* Consult documentation or Archive.c for more information. */
+ArchiveWriter CreateArchiveWriter(const char *filename, int quantum, int compress);
+
+void ArchiveWrite(ArchiveWriter writer, Process process);
+
+int DestroyArchiveWriter(ArchiveWriter writer);
+
+int IsArchive(FILE *fp);
+
+Archive OpenArchive(FILE *fp);
+
+int ArchiveQuantum(Archive archive);
+
+Process ArchiveNext(gpointer archive);
+
+int ArchiveFailed(Archive archive);
+
+void DestroyArchive(Archive archive);
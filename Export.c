@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Export.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Writes the start, finish, wait, response and turnaround time
+ *          of every process to a file, as CSV or as binary columns.
+ *
+ * Error handling:
+ *          If the file can not be created an error message is printed
+ *          and NULL is returned.
+ *
+ * Notes:
+ *          The rows are formatted in a large buffer while a writer
+ *          thread writes the other buffer, so the simulation only waits
+ *          when the disk is slower than the simulation. Numbers are
+ *          formatted by hand two digits at a time instead of with
+ *          printf.
+ *
+ *          The binary file starts with the magic "SCHX", the version and
+ *          the number of columns as 32 bit integers. Then come blocks of
+ *          up to BLOCK_ROWS rows: the number of rows followed by every
+ *          column of the block, each one an array of 32 bit integers in
+ *          the byte order of the machine. The columns are algorithm,
+ *          id, arrival, start, finish, wait, response and turnaround.
+ *
+ */
+#include <stdio.h>     /* Used for fopen and fwrite */
+#include <stdlib.h>    /* Used for memory manipulation */
+#include <string.h>    /* Used for memcpy and strlen */
+#include <glib.h>      /* Used for GThread, GMutex and GCond */
+#include "FileIO.h"    /* Used for ErrorMsg */
+#include "Process.h"   /* Used for the data structures and enums */
+#include "Export.h"    /* Function header */
+
+#define COLUMNS 8               //!< Values written per process.
+#define BLOCK_ROWS 32768        //!< Rows of a binary block.
+#define BLOCK_BYTES (COLUMNS * BLOCK_ROWS * 4) //!< Size of each buffer.
+#define MAX_ROW 160             //!< Longest CSV line.
+#define VERSION 1               //!< Version of the binary format.
+
+/* Declaration of the data structure block_p with one of the two buffers */
+struct block_p
+{
+    char *data; /* Text of the CSV lines or the columns of the rows */
+    long size;  /* Bytes of text used */
+    int rows;   /* Rows in the buffer */
+};
+
+/* Declaration of the data structure exporter_p with the buffers and the writer */
+struct exporter_p
+{
+    FILE *fp;                 /* File being written */
+    int format;               /* Value of export_format */
+    struct block_p blocks[2]; /* The buffer being filled and the one being written */
+    int current;              /* Index of the buffer being filled */
+    struct block_p *pending;  /* Buffer handed to the writer, NULL when it is idle */
+    int done;                 /* 1 once no more buffers will be handed */
+    GThread *writer;          /* Thread that writes the buffers */
+    GMutex lock;              /* Protects pending and done */
+    GCond cond;               /* Signals changes of pending and done */
+};
+
+/* Short names of the algorithms, in the order of algorithm_type */
+static const char *names[NUM_ALGORITHMS] = {"FCFS", "NPP", "NPSJF", "PP", "PSJF", "RR",
+                                            "LOTTERY", "STRIDE", "NPEDF", "PEDF", "FAIR"};
+
+/* Pairs of digits from 00 to 99 */
+static const char digits[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/*!
+* Writes an integer in decimal.
+*
+* Receive param out Where the text is written, needs 11 characters
+* Receive param value The integer
+*
+* return Number of characters written
+*/
+static int formatInt(char *out, int value)
+{
+    char text[12];
+    char *p = text + sizeof(text);
+    unsigned int magnitude = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+    int length;
+    /* The digits are produced from the end, two at a time */
+    while (magnitude >= 100)
+    {
+        p -= 2;
+        memcpy(p, digits + (magnitude % 100) * 2, 2);
+        magnitude /= 100;
+    }
+    if (magnitude >= 10)
+    {
+        p -= 2;
+        memcpy(p, digits + magnitude * 2, 2);
+    }
+    else
+    {
+        *--p = (char)('0' + magnitude);
+    }
+    if (value < 0)
+        *--p = '-';
+    length = (int)(text + sizeof(text) - p);
+    memcpy(out, p, length);
+    return length;
+}
+
+/*!
+* Writes a buffer to the file.
+*
+* Receive param exporter The exporter
+* Receive param block The buffer
+*/
+static void writeBlock(Exporter exporter, struct block_p *block)
+{
+    int column;
+    if (exporter->format == EXPORT_CSV)
+    {
+        fwrite(block->data, 1, block->size, exporter->fp);
+        return;
+    }
+    fwrite(&block->rows, sizeof(int), 1, exporter->fp);
+    for (column = 0; column < COLUMNS; column++)
+        fwrite(block->data + (long)column * BLOCK_ROWS * sizeof(int), sizeof(int), block->rows, exporter->fp);
+}
+
+/*!
+* Body of the writer thread, writes every buffer it is handed.
+*
+* Receive param data The exporter
+*
+* return NULL
+*/
+static gpointer writerThread(gpointer data)
+{
+    Exporter exporter = data;
+    struct block_p *block;
+    while (1)
+    {
+        g_mutex_lock(&exporter->lock);
+        while (exporter->pending == NULL && !exporter->done)
+            g_cond_wait(&exporter->cond, &exporter->lock);
+        block = exporter->pending;
+        g_mutex_unlock(&exporter->lock);
+        if (block == NULL)
+            break;
+        writeBlock(exporter, block);
+        block->size = 0;
+        block->rows = 0;
+        /* The buffer is free again */
+        g_mutex_lock(&exporter->lock);
+        exporter->pending = NULL;
+        g_cond_signal(&exporter->cond);
+        g_mutex_unlock(&exporter->lock);
+    }
+    return NULL;
+}
+
+/*!
+* Hands the buffer being filled to the writer and continues in the other.
+*
+* Receive param exporter The exporter
+*
+* Waits only if the writer is still busy with the other buffer.
+*/
+static void handOff(Exporter exporter)
+{
+    g_mutex_lock(&exporter->lock);
+    while (exporter->pending != NULL)
+        g_cond_wait(&exporter->cond, &exporter->lock);
+    exporter->pending = &exporter->blocks[exporter->current];
+    g_cond_signal(&exporter->cond);
+    g_mutex_unlock(&exporter->lock);
+    exporter->current ^= 1;
+}
+
+/*!
+* Creates the export file and starts its writer.
+*
+* Receive param filename Name of the file
+* Receive param format Value of export_format
+*
+* return Pointer to the exporter or NULL on error
+*/
+Exporter CreateExporter(const char *filename, int format)
+{
+    Exporter exporter;
+    FILE *fp = fopen(filename, (format == EXPORT_CSV) ? "w" : "wb");
+    int header[3] = {0, VERSION, COLUMNS};
+    const char *title = "algorithm,id,arrival,start,finish,wait,response,turnaround\n";
+    int i;
+    if (fp == NULL)
+    {
+        ErrorMsg("CreateExporter", "export file could not be created");
+        return NULL;
+    }
+    /* The buffers are already large, stdio does not need to copy them again */
+    setvbuf(fp, NULL, _IONBF, 0);
+    exporter = (Exporter)calloc(1, sizeof(struct exporter_p));
+    exporter->fp = fp;
+    exporter->format = format;
+    for (i = 0; i < 2; i++)
+        exporter->blocks[i].data = (char *)malloc(BLOCK_BYTES);
+    if (format == EXPORT_CSV)
+    {
+        fwrite(title, 1, strlen(title), fp);
+    }
+    else
+    {
+        memcpy(header, "SCHX", 4);
+        fwrite(header, sizeof(int), 3, fp);
+    }
+    g_mutex_init(&exporter->lock);
+    g_cond_init(&exporter->cond);
+    exporter->writer = g_thread_new("export", writerThread, exporter);
+    return exporter;
+}
+
+/*!
+* Adds the results of a finished process.
+*
+* Receive param exporter The exporter
+* Receive param algorithm Value of algorithm_type that scheduled the process
+* Receive param process The process
+* Receive param finish Time the process finished
+*/
+void ExportProcess(Exporter exporter, int algorithm, Process process, int finish)
+{
+    struct block_p *block = &exporter->blocks[exporter->current];
+    int values[COLUMNS];
+    int *columns;
+    char *p;
+    int i;
+    values[0] = algorithm;
+    values[1] = process->process_id;
+    values[2] = process->process_arrival;
+    values[3] = process->process_starttime;
+    values[4] = finish;
+    values[5] = finish - process->process_arrival - process->process_burst - process->process_iotime;
+    values[6] = process->process_starttime - process->process_arrival;
+    values[7] = finish - process->process_arrival;
+    if (exporter->format == EXPORT_BINARY)
+    {
+        columns = (int *)block->data;
+        for (i = 0; i < COLUMNS; i++)
+            columns[i * BLOCK_ROWS + block->rows] = values[i];
+        if (++block->rows == BLOCK_ROWS)
+            handOff(exporter);
+        return;
+    }
+    p = block->data + block->size;
+    i = (int)strlen(names[algorithm]);
+    memcpy(p, names[algorithm], i);
+    p += i;
+    for (i = 1; i < COLUMNS; i++)
+    {
+        *p++ = ',';
+        p += formatInt(p, values[i]);
+    }
+    *p++ = '\n';
+    block->size = p - block->data;
+    block->rows++;
+    if (block->size > BLOCK_BYTES - MAX_ROW)
+        handOff(exporter);
+}
+
+/*!
+* Writes the rows left, stops the writer and closes the file.
+*
+* Receive param exporter The exporter to destroy
+*/
+void DestroyExporter(Exporter exporter)
+{
+    int i;
+    if (exporter->blocks[exporter->current].rows > 0)
+        handOff(exporter);
+    g_mutex_lock(&exporter->lock);
+    exporter->done = 1;
+    g_cond_signal(&exporter->cond);
+    g_mutex_unlock(&exporter->lock);
+    g_thread_join(exporter->writer);
+    g_mutex_clear(&exporter->lock);
+    g_cond_clear(&exporter->cond);
+    fclose(exporter->fp);
+    for (i = 0; i < 2; i++)
+        free(exporter->blocks[i].data);
+    free(exporter);
+}
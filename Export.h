@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Export.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the export of the results of every process
+ *
+ * Notes:
+ *          Requires glib.h, stdio.h and Process.h to be included first.
+ *
+ */
+
+/* Enumeration of the formats of the exported file */
+enum export_format
+{
+  EXPORT_CSV,   /* One line of text per process */
+  EXPORT_BINARY /* Blocks of rows stored column by column */
+};
+
+/* We make a typedef to facilitate declaration of exporter_p structures */
+typedef struct exporter_p *Exporter;
+
+/* Consult documentation or Export.c for more information. */
+Exporter CreateExporter(const char *filename, int format);
+
+void ExportProcess(Exporter exporter, int algorithm, Process process, int finish);
+
+void DestroyExporter(Exporter exporter);
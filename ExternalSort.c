@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: ExternalSort.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Sorts by arrival time process files larger than the memory
+ *          available and hands the processes one at a time in order.
+ *
+ * References:
+ *          External merge sort: sorted runs are written to temporary
+ *          files and merged with a heap that holds one record per run.
+ *
+ * Error handling:
+ *          If a temporary file can not be created or written an error
+ *          message is printed and NULL is returned.
+ *
+ * Notes:
+ *          Only the budget given in bytes is kept in memory. While the
+ *          file is read, records are collected until the budget is full,
+ *          sorted with a radix sort and spilled as a run. The runs are then merged reading
+ *          each one through a buffer that shares the same budget. Ties
+ *          are broken by the position in the file, like g_list_sort.
+ *
+ *          The list of bursts of a process has any length, so a record
+ *          in a run is followed by its bursts and the runs are read one
+ *          record at a time through their stdio buffer.
+ *
+ */
+#include <stdio.h>          /* Used for tmpfile, fread and fwrite */
+#include <stdlib.h>         /* Used for memory manipulation */
+#include <string.h>         /* Used for memcpy */
+#include <glib.h>           /* Used for gpointer */
+#include "FileIO.h"         /* Used for ErrorMsg */
+#include "Process.h"        /* Used for the data structures */
+#include "Heap.h"           /* Used to merge the runs */
+#include "RadixSort.h"      /* Used to sort the runs */
+#include "ExternalSort.h"   /* Function header */
+
+#define MIN_RECORDS 1024  //!< Smallest number of records kept in memory.
+#define MIN_BUFFER 4096   //!< Smallest buffer in bytes used to read a run.
+
+/* Declaration of the data structure run_p that reads back one sorted run */
+struct run_p
+{
+    FILE *fp;                 /* Temporary file with the run, NULL if it is in memory */
+    char *buffer;             /* Buffer of the temporary file */
+    struct record_p *records; /* Records of the run kept in memory */
+    int *pool;                /* Bursts of the records kept in memory */
+    long size;                /* Number of records kept in memory */
+    long next;                /* Position of the next record in memory */
+    struct record_p head;     /* Next record of the run */
+    int *bursts;              /* Bursts of the next record */
+    int capacity;             /* Number of bursts that fit in bursts */
+    int index;                /* Order of the run in the file, used for ties */
+};
+
+/* Declaration of the data structure external_sort_p with the state of the merge */
+struct external_sort_p
+{
+    struct run_p *runs; /* The sorted runs */
+    int count;          /* Number of runs */
+    Heap merge;         /* Runs ordered by their next record */
+};
+
+/*!
+* Sorts an array of records by arrival time keeping the order of ties.
+*
+* Receive param records Array to sort
+* Receive param temp Array of the same size used as scratch space
+* Receive param items Array of 2 * n items used for the radix sort
+* Receive param n Number of records
+*
+* The bursts of the records stay in the pool, only their offsets move.
+*/
+static void sortRecords(struct record_p *records, struct record_p *temp, RadixItem *items, long n)
+{
+    long i;
+    for (i = 0; i < n; i++)
+    {
+        items[i].key = RADIX_KEY(records[i].arrival);
+        items[i].data = &records[i];
+    }
+    RadixSort(items, items + n, n, 4);
+    /* The records are gathered in the sorted order */
+    for (i = 0; i < n; i++)
+        temp[i] = *(struct record_p *)items[i].data;
+    memcpy(records, temp, n * sizeof(struct record_p));
+}
+
+/*!
+* Loads the next record of a run in its head.
+*
+* Receive param run The run to read
+*
+* return 1 if a record was loaded, 0 when the run is exhausted
+*/
+static int nextRecord(struct run_p *run)
+{
+    if (run->fp == NULL)
+    {
+        if (run->next >= run->size)
+            return 0;
+        run->head = run->records[run->next++];
+        run->bursts = run->pool + run->head.bursts;
+        return 1;
+    }
+    if (fread(&run->head, sizeof(struct record_p), 1, run->fp) != 1)
+        return 0;
+    if (run->head.nbursts > run->capacity)
+    {
+        run->capacity = run->head.nbursts;
+        run->bursts = (int *)realloc(run->bursts, run->capacity * sizeof(int));
+    }
+    if (run->head.nbursts > 0 && fread(run->bursts, sizeof(int), run->head.nbursts, run->fp) != (size_t)run->head.nbursts)
+        return 0;
+    return 1;
+}
+
+/*!
+* Compares runs by their next record, ties are broken by run order.
+*
+* Receive param a Pointer to the first run
+* Receive param b Pointer to the second run
+*
+* return a negative value if the next record of a goes first
+*/
+static gint compareRuns(gconstpointer a, gconstpointer b)
+{
+    const struct run_p *aa = a;
+    const struct run_p *bb = b;
+    int compare = aa->head.arrival - bb->head.arrival;
+    if (compare == 0)
+        compare = aa->index - bb->index;
+    return compare;
+}
+
+/*!
+* Writes a sorted run to a temporary file.
+*
+* Receive param records The sorted records
+* Receive param pool The bursts of the records
+* Receive param n Number of records
+*
+* return The temporary file positioned at its start or NULL on error
+*
+* Every record is followed by its list of bursts.
+*/
+static FILE *spillRun(struct record_p *records, int *pool, long n)
+{
+    FILE *fp = tmpfile();
+    long i;
+    if (fp == NULL)
+    {
+        ErrorMsg("spillRun", "temporary file could not be created");
+        return NULL;
+    }
+    for (i = 0; i < n; i++)
+    {
+        if (fwrite(&records[i], sizeof(struct record_p), 1, fp) != 1 ||
+            fwrite(pool + records[i].bursts, sizeof(int), records[i].nbursts, fp)
+                != (size_t)records[i].nbursts)
+            break;
+    }
+    if (i < n || fflush(fp) != 0)
+    {
+        ErrorMsg("spillRun", "temporary file could not be written");
+        fclose(fp);
+        return NULL;
+    }
+    rewind(fp);
+    return fp;
+}
+
+/*!
+* Reads a process file and leaves it ready to be merged in arrival order.
+*
+* Receive param fp Process file positioned after the quantum
+* Receive param budget Bytes of memory that may be used for records
+*
+* return Pointer to the sorter or NULL on error
+*
+* Half of the budget holds the records and the other half their lists
+  of bursts. When the whole file fits in the budget it is sorted in
+  memory and no temporary file is created.
+*/
+ExternalSort CreateExternalSort(FILE *fp, long budget)
+{
+    ExternalSort sorter;
+    struct record_p *records, *temp;
+    RadixItem *items;
+    int *pool;
+    /* Records per run, each one also needs a scratch record and two radix items */
+    long limit = budget / (4 * (long)(sizeof(struct record_p) + sizeof(RadixItem)));
+    long pooled = budget / (2 * (long)sizeof(int));
+    long n = 0, used = 0, share;
+    int i;
+    FILE *run;
+    GList *files = NULL, *l;
+    Process process;
+
+    if (limit < MIN_RECORDS)
+        limit = MIN_RECORDS;
+    if (pooled < limit)
+        pooled = limit;
+    records = (struct record_p *)malloc(limit * sizeof(struct record_p));
+    temp = (struct record_p *)malloc(limit * sizeof(struct record_p));
+    items = (RadixItem *)malloc(2 * limit * sizeof(RadixItem));
+    pool = (int *)malloc(pooled * sizeof(int));
+    /* Runs are spilled every time the records or the pool are full */
+    do
+    {
+        process = ReadProcess(fp);
+        if (n == limit || (process != NULL && n > 0 && used + process->process_nbursts > pooled) ||
+            (process == NULL && n > 0 && files != NULL))
+        {
+            sortRecords(records, temp, items, n);
+            if ((run = spillRun(records, pool, n)) == NULL)
+            {
+                for (l = files; l != NULL; l = l->next)
+                    fclose(l->data);
+                g_list_free(files);
+                if (process != NULL)
+                    freeNode(process);
+                free(records);
+                free(temp);
+                free(items);
+                free(pool);
+                return NULL;
+            }
+            files = g_list_append(files, run);
+            n = 0;
+            used = 0;
+        }
+        if (process != NULL)
+        {
+            /* A list of bursts larger than the whole pool gets a pool of its own */
+            if (process->process_nbursts > pooled)
+            {
+                pooled = process->process_nbursts;
+                pool = (int *)realloc(pool, pooled * sizeof(int));
+            }
+            records[n].id = process->process_id;
+            records[n].arrival = process->process_arrival;
+            records[n].burst = process->process_burst;
+            records[n].priority = process->process_priority;
+            records[n].deadline = process->process_deadline;
+            records[n].group = process->process_group;
+            records[n].nbursts = (process->process_bursts != NULL) ? process->process_nbursts : 0;
+            records[n].bursts = used;
+            memcpy(pool + used, process->process_bursts, records[n].nbursts * sizeof(int));
+            used += records[n].nbursts;
+            n++;
+            freeNode(process);
+        }
+    } while (process != NULL);
+
+    sorter = (ExternalSort)malloc(sizeof(struct external_sort_p));
+    sorter->merge = CreateHeap(compareRuns);
+    if (files == NULL)
+    {
+        /* Everything fit in memory, the only run is the buffer itself */
+        sortRecords(records, temp, items, n);
+        free(temp);
+        free(items);
+        sorter->count = 1;
+        sorter->runs = (struct run_p *)calloc(1, sizeof(struct run_p));
+        sorter->runs[0].records = records;
+        sorter->runs[0].pool = pool;
+        sorter->runs[0].size = n;
+        if (nextRecord(&sorter->runs[0]))
+            HeapPush(sorter->merge, &sorter->runs[0]);
+        return sorter;
+    }
+    free(records);
+    free(temp);
+    free(items);
+    free(pool);
+
+    /* The budget is shared between the file buffers of all the runs */
+    sorter->count = g_list_length(files);
+    sorter->runs = (struct run_p *)calloc(sorter->count, sizeof(struct run_p));
+    share = budget / sorter->count;
+    if (share < MIN_BUFFER)
+        share = MIN_BUFFER;
+    for (l = files, i = 0; l != NULL; l = l->next, i++)
+    {
+        sorter->runs[i].fp = l->data;
+        sorter->runs[i].buffer = (char *)malloc(share);
+        setvbuf(sorter->runs[i].fp, sorter->runs[i].buffer, _IOFBF, share);
+        sorter->runs[i].index = i;
+        if (nextRecord(&sorter->runs[i]))
+            HeapPush(sorter->merge, &sorter->runs[i]);
+    }
+    g_list_free(files);
+    return sorter;
+}
+
+/*!
+* Returns the next process in arrival order.
+*
+* Receive param sorter The sorter, as a gpointer so it can be used as a ProcessSource
+*
+* return A new process or NULL once every run is exhausted
+*/
+Process ExternalSortNext(gpointer sorter)
+{
+    ExternalSort s = sorter;
+    struct run_p *run = HeapPop(s->merge);
+    struct record_p *record;
+    Process process;
+    int i;
+    if (run == NULL)
+        return NULL;
+    record = &run->head;
+    process = NewProcess(record->id, record->arrival, record->burst, record->priority);
+    process->process_deadline = record->deadline;
+    process->process_group = record->group;
+    if (record->nbursts > 0)
+    {
+        process->process_nbursts = record->nbursts;
+        process->process_bursts = (int *)malloc(record->nbursts * sizeof(int));
+        memcpy(process->process_bursts, run->bursts, record->nbursts * sizeof(int));
+        for (i = 1; i < record->nbursts; i += 2)
+            process->process_iotime += run->bursts[i];
+    }
+    /* The run goes back to the heap if it still has records */
+    if (nextRecord(run))
+        HeapPush(s->merge, run);
+    return process;
+}
+
+/*!
+* Frees the memory of a sorter and closes its temporary files.
+*
+* Receive param sorter The sorter to destroy
+*/
+void DestroyExternalSort(ExternalSort sorter)
+{
+    int i;
+    for (i = 0; i < sorter->count; i++)
+    {
+        if (sorter->runs[i].fp != NULL)
+        {
+            fclose(sorter->runs[i].fp);
+            free(sorter->runs[i].bursts);
+            free(sorter->runs[i].buffer);
+        }
+        else
+        {
+            free(sorter->runs[i].records);
+            free(sorter->runs[i].pool);
+        }
+    }
+    free(sorter->runs);
+    DestroyHeap(sorter->merge, NULL);
+    free(sorter);
+}
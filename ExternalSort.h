@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: ExternalSort.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the external sort of process files that
+ *          do not fit in memory
+ *
+ * Notes:
+ *          Requires glib.h, stdio.h and Process.h to be included first.
+ *
+ */
+
+/* Declaration of the data structure record_p used to store a process in the runs */
+struct record_p
+{
+  int id;       /* The id of the process */
+  int arrival;  /* The arrival time of the process */
+  int burst;    /* The cpu burst of the process */
+  int priority; /* The priority of the process */
+  int deadline; /* The absolute deadline of the process or NO_DEADLINE */
+  int group;    /* The group of the process */
+  int nbursts;  /* Number of CPU and I/O bursts, 0 for a single burst */
+  long bursts;  /* Offset of the bursts in the pool while in memory */
+};
+
+/* We make a typedef to facilitate declaration of external_sort_p structures */
+typedef struct external_sort_p *ExternalSort;
+
+/* Consult documentation or ExternalSort.c for more information. */
+ExternalSort CreateExternalSort(FILE *fp, long budget);
+
+Process ExternalSortNext(gpointer sorter);
+
+void DestroyExternalSort(ExternalSort sorter);
@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: FairShare.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Ready queue that shares the CPU between a tree of groups of
+ *          processes in proportion to their weights.
+ *
+ * References:
+ *          Virtual runtime ordering as in the Linux completely fair
+ *          scheduler with group scheduling.
+ *
+ * Error handling:
+ *          A group that would be its own ancestor prints an error
+ *          message and stays under the root.
+ *
+ * Notes:
+ *          Every group is a node with a weight and two heaps, one with
+ *          its child groups that have processes ready and one with its
+ *          own ready processes, both ordered by virtual runtime. When
+ *          something runs for some time, its virtual runtime and the one
+ *          of every group above it grow by that time divided by their
+ *          weight, so the entity that received less than its share has
+ *          the lowest virtual runtime. Picking walks from the root to a
+ *          process taking the lowest of the two heads at each level, so
+ *          it costs O(depth * log fan-out). The groups on the path leave
+ *          their heaps while the process runs and return once it has
+ *          been charged. An entity that becomes ready starts at the
+ *          lowest virtual runtime picked in its parent, so sleeping does
+ *          not build up credit.
+ *
+ *          Group 0 is the root. Groups that are not in the table hang
+ *          from the root with the weight of a process of priority 0.
+ *
+ */
+#include <stdio.h>       /* Used for the FILE type */
+#include <stdlib.h>      /* Used for memory manipulation */
+#include <glib.h>        /* Used for gpointer, GCompareFunc and GHashTable */
+#include "FileIO.h"      /* Used for GetLine and ErrorMsg */
+#include "Process.h"     /* Used for the data structures */
+#include "Heap.h"        /* Used for the run queues of the groups */
+#include "FairShare.h"   /* Function header */
+
+#define GROUP_VALUES 3        //!< Values of a line of the group table: id, parent and weight.
+#define DEFAULT_WEIGHT 1000   //!< Weight of a group not in the table, like a priority 0 process.
+#define VRUNTIME_ONE (1 << 20) //!< Virtual runtime of one unit of time at weight 1.
+
+/* Declaration of the data structure group_table_p with the groups read from a file */
+struct group_table_p
+{
+    int *values; /* Id, parent and weight of every group */
+    int count;   /* Number of groups */
+};
+
+/* Declaration of the data structure fair_node_p, one group of the tree */
+struct fair_node_p
+{
+    int id;                     /* Id of the group */
+    int weight;                 /* Share of the group against its siblings */
+    struct fair_node_p *parent; /* Group above, NULL for the root */
+    long long vruntime;         /* Time used divided by the weight */
+    long long minVruntime;      /* Highest virtual runtime picked among its children */
+    Heap groups;                /* Child groups with processes ready */
+    Heap processes;             /* Processes of the group that are ready */
+    int queued;                 /* 1 if the group is in the heap of its parent */
+    int onPath;                 /* 1 if a process of the group or below is running */
+};
+
+/* Declaration of the data structure fair_share_p with the tree of groups */
+struct fair_share_p
+{
+    GHashTable *nodes;          /* Groups by id */
+    struct fair_node_p *root;   /* Group 0 */
+    int size;                   /* Processes ready */
+};
+
+/*!
+* Compares groups by virtual runtime, ties are broken by ID.
+*
+* Receive param a Pointer to the first group
+* Receive param b Pointer to the second group
+*
+* return a negative value if a goes first
+*/
+static gint compareGroups(gconstpointer a, gconstpointer b)
+{
+    const struct fair_node_p *aa = a;
+    const struct fair_node_p *bb = b;
+    if (aa->vruntime != bb->vruntime)
+        return (aa->vruntime < bb->vruntime) ? -1 : 1;
+    return aa->id - bb->id;
+}
+
+/*!
+* Compares processes by virtual runtime, ties are broken by ID.
+*
+* Receive param a Pointer to the first process
+* Receive param b Pointer to the second process
+*
+* return a negative value if a goes first
+*/
+static gint compareProcesses(gconstpointer a, gconstpointer b)
+{
+    const struct process_p *aa = a;
+    const struct process_p *bb = b;
+    if (aa->process_pass != bb->process_pass)
+        return (aa->process_pass < bb->process_pass) ? -1 : 1;
+    return aa->process_id - bb->process_id;
+}
+
+/*!
+* Reads a table of groups.
+*
+* Receive param fp File with one group per line: id, parent and weight
+*
+* return Pointer to the table
+*/
+GroupTable ReadGroupTable(FILE *fp)
+{
+    GroupTable table = (GroupTable)malloc(sizeof(struct group_table_p));
+    int values[GROUP_VALUES];
+    int capacity = 16;
+    table->values = (int *)malloc(capacity * GROUP_VALUES * sizeof(int));
+    table->count = 0;
+    while (GetLine(fp, values, GROUP_VALUES) >= 0)
+    {
+        if (values[0] <= 0 || values[2] <= 0)
+            continue;
+        if (table->count == capacity)
+        {
+            capacity *= 2;
+            table->values = (int *)realloc(table->values, capacity * GROUP_VALUES * sizeof(int));
+        }
+        table->values[table->count * GROUP_VALUES] = values[0];
+        table->values[table->count * GROUP_VALUES + 1] = values[1] > 0 ? values[1] : 0;
+        table->values[table->count * GROUP_VALUES + 2] = values[2];
+        table->count++;
+    }
+    return table;
+}
+
+/*!
+* Returns the number of groups in a table.
+*
+* Receive param table The groups
+*
+* return The number of lines read
+*/
+int GroupTableSize(GroupTable table)
+{
+    return table->count;
+}
+
+/*!
+* Returns a group of a table and its parent.
+*
+* Receive param table The groups
+* Receive param i Index of the group, from 0 to its size minus one
+* Receive param id Where the id of the group is stored
+*
+* return The id of the parent, 0 for the root
+*/
+int GroupTableEntry(GroupTable table, int i, int *id)
+{
+    *id = table->values[i * GROUP_VALUES];
+    return table->values[i * GROUP_VALUES + 1];
+}
+
+/*!
+* Frees the memory of a table of groups.
+*
+* Receive param table The table to destroy
+*/
+void DestroyGroupTable(GroupTable table)
+{
+    free(table->values);
+    free(table);
+}
+
+/*!
+* Returns the node of a group, creating it under the root if needed.
+*
+* Receive param fair The ready queue
+* Receive param id Id of the group, negative ids are the root
+*
+* return Pointer to the node
+*/
+static struct fair_node_p *getNode(FairShare fair, int id)
+{
+    struct fair_node_p *node;
+    if (id < 0)
+        id = 0;
+    node = g_hash_table_lookup(fair->nodes, GINT_TO_POINTER(id));
+    if (node == NULL)
+    {
+        node = (struct fair_node_p *)calloc(1, sizeof(struct fair_node_p));
+        node->id = id;
+        node->weight = DEFAULT_WEIGHT;
+        node->parent = fair->root;
+        node->groups = CreateHeap(compareGroups);
+        node->processes = CreateHeap(compareProcesses);
+        g_hash_table_insert(fair->nodes, GINT_TO_POINTER(id), node);
+    }
+    return node;
+}
+
+/*!
+* Creates an empty ready queue with the groups of a table.
+*
+* Receive param table The groups, NULL if every group hangs from the root
+*
+* return Pointer to the new ready queue
+*/
+FairShare CreateFairShare(GroupTable table)
+{
+    FairShare fair = (FairShare)malloc(sizeof(struct fair_share_p));
+    struct fair_node_p *node, *parent, *above;
+    int i;
+    fair->nodes = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+    fair->root = NULL;
+    fair->size = 0;
+    fair->root = getNode(fair, 0);
+    if (table == NULL)
+        return fair;
+    for (i = 0; i < table->count; i++)
+    {
+        node = getNode(fair, table->values[i * GROUP_VALUES]);
+        parent = getNode(fair, table->values[i * GROUP_VALUES + 1]);
+        node->weight = table->values[i * GROUP_VALUES + 2];
+        /* The parent can not be the group itself or one of its descendants */
+        for (above = parent; above != NULL && above != node; above = above->parent)
+            ;
+        if (above == node)
+            ErrorMsg("CreateFairShare", "group would be its own ancestor");
+        else
+            node->parent = parent;
+    }
+    return fair;
+}
+
+/*!
+* Puts a group with processes ready in the heap of its parent, and the
+* groups above it if they were not there.
+*
+* Receive param node The group that has processes ready
+*/
+static void activate(struct fair_node_p *node)
+{
+    for (; node->parent != NULL && !node->queued && !node->onPath; node = node->parent)
+    {
+        if (node->vruntime < node->parent->minVruntime)
+            node->vruntime = node->parent->minVruntime;
+        HeapPush(node->parent->groups, node);
+        node->queued = 1;
+    }
+}
+
+/*!
+* Puts a process in the ready queue of its group.
+*
+* Receive param fair The ready queue
+* Receive param process The process that becomes ready
+*/
+void FairShareAdd(FairShare fair, Process process)
+{
+    struct fair_node_p *node = getNode(fair, process->process_group);
+    if (process->process_pass < node->minVruntime)
+        process->process_pass = node->minVruntime;
+    HeapPush(node->processes, process);
+    fair->size++;
+    activate(node);
+}
+
+/*!
+* Takes the process that should run next out of the ready queue.
+*
+* Receive param fair The ready queue
+*
+* return The process or NULL if there is none ready
+*/
+Process FairSharePick(FairShare fair)
+{
+    struct fair_node_p *node = fair->root, *group;
+    Process process;
+    if (fair->size == 0)
+        return NULL;
+    while (1)
+    {
+        group = HeapPeek(node->groups);
+        process = HeapPeek(node->processes);
+        /* The entity with the lowest virtual runtime goes down, processes win ties */
+        if (group != NULL && (process == NULL || group->vruntime < process->process_pass))
+        {
+            HeapPop(node->groups);
+            group->queued = 0;
+            group->onPath = 1;
+            if (group->vruntime > node->minVruntime)
+                node->minVruntime = group->vruntime;
+            node = group;
+        }
+        else
+        {
+            HeapPop(node->processes);
+            if (process->process_pass > node->minVruntime)
+                node->minVruntime = process->process_pass;
+            fair->size--;
+            return process;
+        }
+    }
+}
+
+/*!
+* Charges the time a process ran to it and to every group above it.
+*
+* Receive param fair The ready queue
+* Receive param process The process that left the CPU
+* Receive param weight Share of the process against the other entities of its group
+* Receive param used Time the process ran
+*
+* Must be called once for every process picked, when it leaves the CPU
+  and before it is added again. The groups of the path go back to the
+  heaps of their parents if they still have processes ready.
+*/
+void FairShareCharge(FairShare fair, Process process, int weight, int used)
+{
+    struct fair_node_p *node;
+    process->process_pass += (long long)used * VRUNTIME_ONE / (weight > 0 ? weight : 1);
+    for (node = getNode(fair, process->process_group); node->parent != NULL; node = node->parent)
+    {
+        node->vruntime += (long long)used * VRUNTIME_ONE / node->weight;
+        node->onPath = 0;
+        if (HeapSize(node->groups) > 0 || HeapSize(node->processes) > 0)
+        {
+            HeapPush(node->parent->groups, node);
+            node->queued = 1;
+        }
+    }
+}
+
+/*!
+* Returns the number of processes ready.
+*
+* Receive param fair The ready queue
+*
+* return Number of processes waiting for the CPU
+*/
+int FairShareSize(FairShare fair)
+{
+    return fair->size;
+}
+
+/*!
+* Frees the memory of a ready queue.
+*
+* Receive param fair The ready queue to destroy
+* Receive param free_func Function applied to every process left, can be NULL
+*/
+void DestroyFairShare(FairShare fair, GDestroyNotify free_func)
+{
+    GHashTableIter iter;
+    gpointer key, value;
+    struct fair_node_p *node;
+    g_hash_table_iter_init(&iter, fair->nodes);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+        node = value;
+        DestroyHeap(node->groups, NULL);
+        DestroyHeap(node->processes, free_func);
+        free(node);
+    }
+    g_hash_table_destroy(fair->nodes);
+    free(fair);
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: FairShare.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the ready queue of hierarchical fair share
+ *          scheduling and the table of groups that configures it
+ *
+ * Notes:
+ *          Requires glib.h, stdio.h and Process.h to be included first.
+ *
+ */
+
+/* We make a typedef to facilitate declaration of group_table_p structures */
+typedef struct group_table_p *GroupTable;
+
+/* We make a typedef to facilitate declaration of fair_share_p structures */
+typedef struct fair_share_p *FairShare;
+
+/* Consult documentation or FairShare.c for more information. */
+GroupTable ReadGroupTable(FILE *fp);
+
+int GroupTableSize(GroupTable table);
+
+int GroupTableEntry(GroupTable table, int i, int *id);
+
+void DestroyGroupTable(GroupTable table);
+
+FairShare CreateFairShare(GroupTable table);
+
+void FairShareAdd(FairShare fair, Process process);
+
+Process FairSharePick(FairShare fair);
+
+void FairShareCharge(FairShare fair, Process process, int weight, int used);
+
+int FairShareSize(FairShare fair);
+
+void DestroyFairShare(FairShare fair, GDestroyNotify free_func);
@@ -19,6 +19,13 @@
  *
  *          May 22 09:13 2012 -- Added recognition of negative numbers.
  *
+ *          Oct 19 10:02 2026 -- Added GetLine for incremental readers.
+ *
+ *          Oct 19 18:10 2026 -- Added GetFields for comma separated values.
+ *
+ *          Oct 19 23:50 2026 -- Added WarningMsg for errors that do not stop
+ *                               the program.
+ *
  * Error handling:
  *          None
  *
@@ -82,6 +89,108 @@ int GetInt(FILE *fp)
     }
 }
 
+/*!
+ *  \brief   The function reads the next line of the input file that
+ *           contains numbers and stores them in values. Comments and
+ *           empty lines are skipped. Unlike GetInt it never reads past
+ *           the end of the line, so it can be used on pipes where the
+ *           next line may not have been written yet.
+ *
+ * \param fp     Pointer to the text file to parse
+ * \param values Array where the numbers are stored
+ * \param max    Size of the values array, extra numbers are ignored
+ *
+ * \return Number of values stored. If the end of file is reached
+ *                     before any number is found a -1 is returned.
+ *
+ */
+int GetLine(FILE *fp, int *values, int max)
+{
+    return (GetFields(fp, values, NULL, max));
+}
+
+/*!
+ *  \brief   Same as GetLine, but also tells which numbers were joined
+ *           to the previous one with a comma, so "1 0 3,4,2 3" can be
+ *           read as four fields where the third one has three numbers.
+ *
+ * \param fp     Pointer to the text file to parse
+ * \param values Array where the numbers are stored
+ * \param joined Array where a 1 is stored for every number that follows
+ *               a comma and a 0 for the rest, can be NULL
+ * \param max    Size of the arrays, extra numbers are ignored
+ *
+ * \return Number of values stored. If the end of file is reached
+ *                     before any number is found a -1 is returned.
+ *
+ */
+int GetFields(FILE *fp, int *values, int *joined, int max)
+{
+    int c, next;   /* Character read and the one that follows a sign */
+    int count = 0; /* Numbers found in the line */
+    int comma = 0; /* A comma was found after the last number */
+    int i, sign;
+
+    while ((c = getc(fp)) != EOF)
+    {
+        if (c == '#') /* Skip the comment, it ends the line */
+        {
+            do
+            {
+                c = getc(fp);
+            } while (c != '\n' && c != EOF);
+        }
+        if (c == '\n' || c == EOF)
+        {
+            if (count > 0)
+                return (count);
+            if (c == EOF)
+                break;
+            continue;
+        }
+        if (c == ',')
+            comma = 1;
+        sign = 1;
+        if (c == '-') /* A minus sign only counts if a digit follows */
+        {
+            next = getc(fp);
+            if (isdigit(next))
+            {
+                sign = -1;
+                c = next;
+            }
+            else
+            {
+                ungetc(next, fp);
+            }
+        }
+        if (isdigit(c))
+        {
+            /* Found 1st digit, begin conversion until a non-digit is found */
+            i = 0;
+            while (isdigit(c))
+            {
+                i = (i * 10) + (c - '0');
+                c = getc(fp);
+            }
+            /* The character after the number may end the line */
+            ungetc(c, fp);
+            if (count < max)
+            {
+                if (joined != NULL)
+                    joined[count] = (comma && count > 0);
+                values[count++] = i * sign;
+            }
+            comma = 0;
+        }
+        else if (c != ',' && !isspace(c))
+        {
+            comma = 0;
+        }
+    }
+    return (count > 0 ? count : -1);
+}
+
 /*!
  *  \brief Prints an error message and then gracefully terminate the
  *           program. This is the release version of assert.
@@ -98,3 +207,19 @@ void ErrorMsg(char *function, char *message)
     printf("\t %s\n", message);
     printf("The program will terminate.\n\n");
 }
+
+/*!
+ *  \brief Prints a warning about something that was skipped, the
+ *           program goes on.
+ *
+ *    \param function Name of the function that found the problem
+ *    \param message String with the warning
+ *
+ *    \return Prints the warning in standard error, so it does not mix
+ *            with the results written to standard output
+ *
+ */
+void WarningMsg(char *function, char *message)
+{
+    fprintf(stderr, "Warning in function %s: %s\n", function, message);
+}
@@ -33,4 +33,7 @@
  **************************************************************/
 
 int GetInt(FILE *fp);
+int GetLine(FILE *fp, int *values, int max);
+int GetFields(FILE *fp, int *values, int *joined, int max);
 void ErrorMsg(char *function, char *message);
+void WarningMsg(char *function, char *message);
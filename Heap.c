@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Heap.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Binary min-heap used by the event driven dispatchers
+ *
+ * Notes:
+ *          Sorting the whole running list every time a process arrives
+ *          costs O(n log n). The heap keeps the element with the lowest
+ *          key on top, so a push or a pop only costs O(log n).
+ *
+ */
+#include <stdlib.h> /* Used for memory manipulation */
+#include <glib.h>   /* Used for gpointer and GCompareFunc */
+#include "Heap.h"   /* Function header */
+
+#define HEAP_INITIAL 64 //!< Initial number of slots reserved for the heap.
+
+/* Declaration of the data structure heap_p that holds the elements of the heap */
+struct heap_p
+{
+    gpointer *items;      /* Array with the elements, items[0] is the top */
+    int size;             /* Number of elements stored */
+    int capacity;         /* Number of slots allocated */
+    GCompareFunc compare; /* Function used to order the elements */
+};
+
+/*!
+* Creates an empty heap.
+*
+* Receive param compare Function that returns a negative value if the first element goes on top
+*
+* return Pointer to the new heap
+*/
+Heap CreateHeap(GCompareFunc compare)
+{
+    Heap heap = (Heap)malloc(sizeof(struct heap_p));
+    heap->items = (gpointer *)malloc(HEAP_INITIAL * sizeof(gpointer));
+    heap->size = 0;
+    heap->capacity = HEAP_INITIAL;
+    heap->compare = compare;
+    return heap;
+}
+
+/*!
+* Adds an element to the heap.
+*
+* Receive param heap The heap where the element is inserted
+* Receive param data The element to insert
+*
+* The element is placed at the end of the array and moved up until
+  its parent is not greater than it.
+*/
+void HeapPush(Heap heap, gpointer data)
+{
+    int i, parent;
+    /* The array doubles its size when it is full */
+    if (heap->size == heap->capacity)
+    {
+        heap->capacity *= 2;
+        heap->items = (gpointer *)realloc(heap->items, heap->capacity * sizeof(gpointer));
+    }
+    /* We move the parents down until we find the place of the new element */
+    for (i = heap->size++; i > 0; i = parent)
+    {
+        parent = (i - 1) / 2;
+        if (heap->compare(heap->items[parent], data) <= 0)
+            break;
+        heap->items[i] = heap->items[parent];
+    }
+    heap->items[i] = data;
+}
+
+/*!
+* Removes the top element of the heap.
+*
+* Receive param heap The heap to pop from
+*
+* return The element with the lowest key or NULL if the heap is empty
+*/
+gpointer HeapPop(Heap heap)
+{
+    gpointer top, last;
+    int i, child;
+    if (heap->size == 0)
+        return NULL;
+    top = heap->items[0];
+    last = heap->items[--heap->size];
+    /* The last element is moved down from the top until both children are greater */
+    for (i = 0; (child = 2 * i + 1) < heap->size; i = child)
+    {
+        if (child + 1 < heap->size && heap->compare(heap->items[child + 1], heap->items[child]) < 0)
+            child++;
+        if (heap->compare(last, heap->items[child]) <= 0)
+            break;
+        heap->items[i] = heap->items[child];
+    }
+    heap->items[i] = last;
+    return top;
+}
+
+/*!
+* Returns the top element without removing it.
+*
+* Receive param heap The heap to look at
+*
+* return The element with the lowest key or NULL if the heap is empty
+*/
+gpointer HeapPeek(Heap heap)
+{
+    return heap->size > 0 ? heap->items[0] : NULL;
+}
+
+/*!
+* Returns the number of elements in the heap.
+*
+* Receive param heap The heap to measure
+*
+* return Number of elements stored
+*/
+int HeapSize(Heap heap)
+{
+    return heap->size;
+}
+
+/*!
+* Frees the memory of a heap.
+*
+* Receive param heap The heap to destroy
+* Receive param free_func Function applied to every element left, can be NULL
+*/
+void DestroyHeap(Heap heap, GDestroyNotify free_func)
+{
+    int i;
+    if (free_func != NULL)
+        for (i = 0; i < heap->size; i++)
+            free_func(heap->items[i]);
+    free(heap->items);
+    free(heap);
+}
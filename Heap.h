@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Heap.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for a binary heap used as a ready queue
+ *
+ * Notes:
+ *          The heap stores gpointer elements and orders them with the
+ *          same kind of GCompareFunc used to sort the process lists.
+ *
+ */
+
+/* We make a typedef to facilitate declaration of heap_p structures */
+typedef struct heap_p *Heap;
+
+/* Consult documentation or Heap.c for more information. */
+Heap CreateHeap(GCompareFunc compare);
+
+void HeapPush(Heap heap, gpointer data);
+
+gpointer HeapPop(Heap heap);
+
+gpointer HeapPeek(Heap heap);
+
+int HeapSize(Heap heap);
+
+void DestroyHeap(Heap heap, GDestroyNotify free_func);
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Histogram.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Histogram of integer values with logarithmic buckets used to
+ *          compute percentiles without keeping every value.
+ *
+ * Error handling:
+ *          None
+ *
+ * Notes:
+ *          Values below 64 in magnitude have a bucket each. Bigger values
+ *          share a bucket with the values that have the same power of two
+ *          and the same next five bits, so a percentile is off by at most
+ *          1/32 of its value. Negative values are kept apart. Adding a
+ *          value is O(1) and the memory used does not depend on how many
+ *          values are added.
+ *
+ */
+#include <stdlib.h>    /* Used for memory manipulation */
+#include "Histogram.h" /* Function header */
+
+#define EXACT 64        //!< Values below this magnitude have a bucket each.
+#define SUB_BITS 5      //!< Bits after the highest one that choose the bucket.
+#define BUCKETS (EXACT + (32 - 6) * (1 << SUB_BITS)) //!< Buckets for one sign.
+
+/* Declaration of the data structure histogram_p with the counters */
+struct histogram_p
+{
+    long long positive[BUCKETS]; /* Counters of the values >= 0 */
+    long long negative[BUCKETS]; /* Counters of the magnitude of the values < 0 */
+    long long count;             /* Number of values added */
+    int max;                     /* Biggest value added */
+};
+
+/*!
+* Returns the bucket of a magnitude.
+*
+* Receive param magnitude Value >= 0
+*
+* return Index of the bucket
+*/
+static int bucketOf(unsigned int magnitude)
+{
+    int bits = 0;
+    if (magnitude < EXACT)
+        return magnitude;
+    /* bits is the position of the highest bit set, 6 or more here */
+    while ((magnitude >> (bits + 1)) != 0)
+        bits++;
+    return EXACT + (bits - 6) * (1 << SUB_BITS) + ((magnitude >> (bits - SUB_BITS)) & ((1 << SUB_BITS) - 1));
+}
+
+/*!
+* Returns the smallest magnitude of a bucket.
+*
+* Receive param bucket Index of the bucket
+*
+* return The magnitude
+*/
+static unsigned int lowerBound(int bucket)
+{
+    int bits, sub;
+    if (bucket < EXACT)
+        return bucket;
+    bits = (bucket - EXACT) / (1 << SUB_BITS) + 6;
+    sub = (bucket - EXACT) % (1 << SUB_BITS);
+    return (1u << bits) | ((unsigned int)sub << (bits - SUB_BITS));
+}
+
+/*!
+* Creates an empty histogram.
+*
+* return Pointer to the new histogram
+*/
+Histogram CreateHistogram(void)
+{
+    return (Histogram)calloc(1, sizeof(struct histogram_p));
+}
+
+/*!
+* Adds a value to the histogram.
+*
+* Receive param histogram The histogram
+* Receive param value The value
+*/
+void HistogramAdd(Histogram histogram, int value)
+{
+    if (histogram->count == 0 || value > histogram->max)
+        histogram->max = value;
+    if (value >= 0)
+        histogram->positive[bucketOf((unsigned int)value)]++;
+    else
+        histogram->negative[bucketOf(0u - (unsigned int)value)]++;
+    histogram->count++;
+}
+
+/*!
+* Returns the number of values added.
+*
+* Receive param histogram The histogram
+*
+* return Number of values
+*/
+long long HistogramCount(Histogram histogram)
+{
+    return histogram->count;
+}
+
+/*!
+* Returns the value below which a percentage of the values fall.
+*
+* Receive param histogram The histogram
+* Receive param percent Percentage between 0 and 100
+*
+* return Lower bound of the bucket of the percentile, 0 if the histogram is empty
+*/
+int HistogramPercentile(Histogram histogram, double percent)
+{
+    long long rank = (long long)(percent / 100.0 * histogram->count);
+    long long seen = 0;
+    int i;
+    if (histogram->count == 0)
+        return 0;
+    if (rank >= histogram->count)
+        rank = histogram->count - 1;
+    /* Negative values go first, from the biggest magnitude down */
+    for (i = BUCKETS - 1; i >= 0; i--)
+    {
+        seen += histogram->negative[i];
+        if (seen > rank)
+            return -(int)lowerBound(i);
+    }
+    for (i = 0; i < BUCKETS; i++)
+    {
+        seen += histogram->positive[i];
+        if (seen > rank)
+            return (int)lowerBound(i);
+    }
+    return histogram->max;
+}
+
+/*!
+* Returns the biggest value added.
+*
+* Receive param histogram The histogram
+*
+* return The exact maximum
+*/
+int HistogramMax(Histogram histogram)
+{
+    return histogram->max;
+}
+
+/*!
+* Frees the memory of a histogram.
+*
+* Receive param histogram The histogram to destroy
+*/
+void DestroyHistogram(Histogram histogram)
+{
+    free(histogram);
+}
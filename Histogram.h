@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Histogram.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the histogram used to compute percentiles
+ *
+ */
+
+/* We make a typedef to facilitate declaration of histogram_p structures */
+typedef struct histogram_p *Histogram;
+
+/* Consult documentation or Histogram.c for more information. */
+Histogram CreateHistogram(void);
+
+void HistogramAdd(Histogram histogram, int value);
+
+long long HistogramCount(Histogram histogram);
+
+int HistogramPercentile(Histogram histogram, double percent);
+
+int HistogramMax(Histogram histogram);
+
+void DestroyHistogram(Histogram histogram);
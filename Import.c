@@ -0,0 +1,771 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Import.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Rebuilds the arrivals and the CPU and I/O bursts of the tasks
+ *          of a Linux scheduler trace and hands them as processes in
+ *          arrival order.
+ *
+ * References:
+ *          The sched_switch, sched_wakeup, sched_wakeup_new and
+ *          sched_process_exit events as printed by "perf sched script"
+ *          and by the ftrace trace and trace_pipe files.
+ *
+ * Error handling:
+ *          Lines that are not one of the events are skipped. If a time,
+ *          or the time the processes could take to finish, does not fit
+ *          in an int with the tick an error message is printed and the
+ *          rest of the trace is ignored.
+ *
+ * Notes:
+ *          The trace is read in one pass. A task that wakes up, or is
+ *          first seen, starts a segment that becomes one process. The
+ *          time it runs until it sleeps is a CPU burst and the time
+ *          until it wakes up again is an I/O burst. Being preempted
+ *          does not end a burst. The segment ends when the task exits,
+ *          when it has MAX_BURSTS bursts or when it is older than the
+ *          window, in which case a running task starts a new segment
+ *          right away and a sleeping one at its next wake up.
+ *
+ *          A process is only known when its segment ends, so finished
+ *          processes wait in a heap until no open segment can start
+ *          before them. The oldest open segment is found with a heap of
+ *          marks, one per segment, whose stale marks are dropped when
+ *          they reach the top. Since no segment is older than the
+ *          window, the memory holds the tasks alive and the processes
+ *          of one window, whatever the size of the trace.
+ *
+ *          Times are microseconds since the first event divided by the
+ *          tick. Unless it is given, the tick of a trace in a file is the
+ *          smallest one that fits the span of the trace times its number
+ *          of CPUs in an int; both are taken from its first and last
+ *          SAMPLE_BYTES, so the trace is still read once. A trace that
+ *          can not be seeked, like a pipe, uses 1. Events slightly out of
+ *          order are moved to the last time seen. The priority is the kernel priority minus 100, so a
+ *          nice 0 task has priority 20 and real time tasks 0.
+ *
+ */
+#include <stdio.h>      /* Used for fgets and fprintf */
+#include <stdlib.h>     /* Used for memory manipulation */
+#include <string.h>     /* Used for strstr and memcpy */
+#include <limits.h>     /* Used for INT_MAX */
+#include <ctype.h>      /* Used for isdigit */
+#include <glib.h>       /* Used for GHashTable */
+#include "FileIO.h"     /* Used for ErrorMsg */
+#include "Process.h"    /* Used for the data structures */
+#include "Heap.h"       /* Used for the finished processes and the marks */
+#include "Import.h"     /* Function header */
+
+#define MAX_TRACE_LINE 4096  //!< Longest line of the trace.
+#define MAX_BURSTS 255       //!< Most bursts of one process.
+#define WINDOW_US 1000000    //!< Longest time in microseconds a segment stays open.
+#define PRIORITY_BASE 100    //!< Kernel priority of the first non real time level.
+#define SAMPLE_BYTES (1 << 20) //!< Bytes read at each end of the trace to choose the tick.
+
+/* States of a task with an open segment */
+enum task_state
+{
+  TASK_RUNNABLE /* Waiting for the CPU */
+  ,
+  TASK_RUNNING /* On a CPU */
+  ,
+  TASK_BLOCKED /* Sleeping, its next wake up ends an I/O burst */
+};
+
+/* Declaration of the data structure task_p with a task that has an open segment */
+struct task_p
+{
+    int pid;          /* Id of the task */
+    int priority;     /* Priority of the segment */
+    int state;        /* Value of task_state */
+    long long start;  /* Time the segment started */
+    long long last;   /* Time it went on the CPU if running, to sleep if blocked */
+    long long cpu;    /* Time on the CPU since the last I/O burst */
+    int bursts[MAX_BURSTS]; /* CPU and I/O bursts alternated, without the current one */
+    int nbursts;      /* Number of values in bursts */
+    long serial;      /* Number of the segment, matches its mark */
+};
+
+/* Declaration of the data structure mark_p with the start of a segment */
+struct mark_p
+{
+    long long start; /* Time the segment started */
+    long serial;     /* Number of the segment */
+    int pid;         /* Task of the segment */
+};
+
+/* Declaration of the data structure importer_p with the state of the trace */
+struct importer_p
+{
+    FILE *fp;           /* Trace being read */
+    int tick;           /* Microseconds per unit of time */
+    long long window;   /* Longest time a segment stays open */
+    long long first;    /* Time of the first event in microseconds, -1 before it */
+    long long now;      /* Time of the last event */
+    GHashTable *tasks;  /* Tasks with an open segment by pid */
+    Heap marks;         /* Starts of the open segments, some of them stale */
+    Heap ready;         /* Processes finished, by arrival */
+    long serial;        /* Number of the last segment */
+    long long work;     /* CPU time of the processes finished */
+    int cpus;           /* Highest CPU seen plus one */
+    int next;           /* Id of the next process */
+    int eof;            /* 1 once the whole trace is read */
+    char line[MAX_TRACE_LINE]; /* Line being parsed */
+};
+
+/*!
+* Compares marks by start, ties are broken by the number of the segment.
+*
+* Receive param a Pointer to the first mark
+* Receive param b Pointer to the second mark
+*
+* return a negative value if a goes first
+*/
+static gint compareMarks(gconstpointer a, gconstpointer b)
+{
+    const struct mark_p *aa = a;
+    const struct mark_p *bb = b;
+    if (aa->start != bb->start)
+        return (aa->start < bb->start) ? -1 : 1;
+    return (aa->serial < bb->serial) ? -1 : (aa->serial > bb->serial);
+}
+
+/*!
+* Compares processes by arrival, ties are broken by ID.
+*
+* Receive param a Pointer to the first process
+* Receive param b Pointer to the second process
+*
+* return a negative value if a goes first
+*/
+static gint compareArrival(gconstpointer a, gconstpointer b)
+{
+    const struct process_p *aa = a;
+    const struct process_p *bb = b;
+    if (aa->process_arrival != bb->process_arrival)
+        return aa->process_arrival - bb->process_arrival;
+    return aa->process_id - bb->process_id;
+}
+
+/*!
+* Returns the start of the first event of a line that the importer uses.
+*
+* Receive param line The line
+*
+* return Pointer to the name of the event or NULL if there is none
+*/
+static char *findEvent(char *line)
+{
+    char *event;
+    for (event = strstr(line, "sched_"); event != NULL; event = strstr(event + 1, "sched_"))
+        if (strncmp(event, "sched_switch:", 13) == 0 || strncmp(event, "sched_wakeup:", 13) == 0 ||
+            strncmp(event, "sched_wakeup_new:", 17) == 0 || strncmp(event, "sched_process_exit:", 19) == 0)
+            return event;
+    return NULL;
+}
+
+/*!
+* Reads the time of an event in microseconds, the number that ends with
+* a colon before its name.
+*
+* Receive param line The line
+* Receive param event Start of the name of the event in the line
+*
+* return The time or -1 if there is none
+*/
+static long long readMicro(const char *line, const char *event)
+{
+    const char *end, *p;
+    long long micro = 0;
+    int digits = 0;
+    /* Skip the rest of the name, like the "sched:" of perf, and the spaces */
+    while (event > line && event[-1] != ' ')
+        event--;
+    while (event > line && event[-1] == ' ')
+        event--;
+    if (event == line || event[-1] != ':')
+        return -1;
+    end = event - 1;
+    for (p = end; p > line && ((p[-1] >= '0' && p[-1] <= '9') || p[-1] == '.'); p--)
+        ;
+    for (; p < end && *p != '.'; p++)
+        micro = micro * 10 + (*p - '0');
+    for (p++; p < end && digits < 6; p++, digits++)
+        micro = micro * 10 + (*p - '0');
+    for (; digits < 6; digits++)
+        micro *= 10;
+    return micro;
+}
+
+/*!
+* Reads the CPU of an event, the number in brackets before its name.
+*
+* Receive param line The line
+* Receive param event Start of the name of the event in the line
+*
+* return The CPU plus one, 0 if there is none
+*/
+static int readCpu(const char *line, const char *event)
+{
+    const char *p = strchr(line, '[');
+    if (p == NULL || p > event || !isdigit((unsigned char)p[1]))
+        return 0;
+    return atoi(p + 1) + 1;
+}
+
+/*!
+* Chooses the tick of a trace from its span and its number of CPUs.
+*
+* Receive param fp The trace, left at its start
+*
+* return Microseconds per unit of time, 1 if the trace can not be seeked
+*
+* The span comes from the first event of the head and the last one of
+  the tail. The CPUs are the highest "[cpu]" before an event in both,
+  or the "#P:" of the ftrace header if higher. The processes of the
+  trace may take up to its span and a window, times the CPUs plus one,
+  to finish, and that must fit in an int, as readTime checks.
+*/
+static int pickTick(FILE *fp)
+{
+    char line[MAX_TRACE_LINE], *event, *p;
+    long size, start, read;
+    long long micro, first = -1, last = -1, need;
+    int cpus = 1, part;
+    if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) <= 0)
+        return 1;
+    for (part = 0; part < 2; part++)
+    {
+        start = (part == 0) ? 0 : size - SAMPLE_BYTES;
+        if (part == 1 && start <= SAMPLE_BYTES)
+            start = SAMPLE_BYTES;
+        if (start >= size || fseek(fp, start, SEEK_SET) != 0)
+            break;
+        /* The first line of the tail is cut */
+        read = (part == 1 && fgets(line, MAX_TRACE_LINE, fp) != NULL) ? (long)strlen(line) : 0;
+        while (read < SAMPLE_BYTES && fgets(line, MAX_TRACE_LINE, fp) != NULL)
+        {
+            read += strlen(line);
+            if ((p = strstr(line, "#P:")) != NULL && atoi(p + 3) > cpus)
+                cpus = atoi(p + 3);
+            if ((event = findEvent(line)) == NULL || (micro = readMicro(line, event)) < 0)
+                continue;
+            if (first < 0)
+                first = micro;
+            if (micro > last)
+                last = micro;
+            if (readCpu(line, event) > cpus)
+                cpus = readCpu(line, event);
+        }
+    }
+    rewind(fp);
+    if (first < 0)
+        return 1;
+    need = (last - first + WINDOW_US) * (cpus + 1);
+    return (int)(need / INT_MAX + 1);
+}
+
+/*!
+* Creates an importer that reads a trace.
+*
+* Receive param fp The trace, read in one pass
+* Receive param tick Microseconds per unit of time, 0 to choose it from the trace
+*
+* return Pointer to the importer
+*/
+Importer CreateImporter(FILE *fp, int tick)
+{
+    Importer importer = (Importer)calloc(1, sizeof(struct importer_p));
+    importer->fp = fp;
+    importer->tick = (tick > 0) ? tick : pickTick(fp);
+    importer->window = WINDOW_US / importer->tick;
+    if (importer->window < 1)
+        importer->window = 1;
+    importer->first = -1;
+    importer->cpus = 1;
+    importer->tasks = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, free);
+    importer->marks = CreateHeap(compareMarks);
+    importer->ready = CreateHeap(compareArrival);
+    importer->next = 1;
+    return importer;
+}
+
+/*!
+* Starts a new segment of a task.
+*
+* Receive param importer The importer
+* Receive param task The task
+* Receive param time Time the segment starts
+*/
+static void openSegment(Importer importer, struct task_p *task, long long time)
+{
+    struct mark_p *mark = (struct mark_p *)malloc(sizeof(struct mark_p));
+    task->start = time;
+    task->cpu = 0;
+    task->nbursts = 0;
+    task->serial = ++importer->serial;
+    mark->start = time;
+    mark->serial = task->serial;
+    mark->pid = task->pid;
+    HeapPush(importer->marks, mark);
+}
+
+/*!
+* Returns a task with an open segment, starting one if it had none.
+*
+* Receive param importer The importer
+* Receive param pid Id of the task
+* Receive param prio Kernel priority of the task
+* Receive param time Time of the event
+*
+* return Pointer to the task
+*/
+static struct task_p *getTask(Importer importer, int pid, int prio, long long time)
+{
+    struct task_p *task = g_hash_table_lookup(importer->tasks, GINT_TO_POINTER(pid));
+    if (task != NULL)
+        return task;
+    task = (struct task_p *)malloc(sizeof(struct task_p));
+    task->pid = pid;
+    task->priority = (prio > PRIORITY_BASE) ? prio - PRIORITY_BASE : 0;
+    task->state = TASK_RUNNABLE;
+    task->last = time;
+    openSegment(importer, task, time);
+    g_hash_table_insert(importer->tasks, GINT_TO_POINTER(pid), task);
+    return task;
+}
+
+/*!
+* Ends the segment of a task and keeps its process until it can be handed.
+*
+* Receive param importer The importer
+* Receive param task The task, still in the table
+*
+* Segments that never ran are dropped.
+*/
+static void closeSegment(Importer importer, struct task_p *task)
+{
+    Process process;
+    int i, cpu = 0;
+    /* A list of bursts always ends with a CPU burst */
+    if (task->nbursts % 2 == 0)
+        task->bursts[task->nbursts++] = (int)task->cpu;
+    task->cpu = 0;
+    task->serial = 0;
+    for (i = 0; i < task->nbursts; i += 2)
+        cpu += task->bursts[i];
+    if (cpu == 0)
+        return;
+    process = NewProcess(importer->next++, (int)task->start, cpu, task->priority);
+    importer->work += cpu;
+    if (task->nbursts > 1)
+    {
+        process->process_nbursts = task->nbursts;
+        process->process_bursts = (int *)malloc(task->nbursts * sizeof(int));
+        memcpy(process->process_bursts, task->bursts, task->nbursts * sizeof(int));
+        for (i = 1; i < task->nbursts; i += 2)
+            process->process_iotime += task->bursts[i];
+    }
+    HeapPush(importer->ready, process);
+}
+
+/*!
+* Ends the segment of a task and forgets the task.
+*
+* Receive param importer The importer
+* Receive param task The task
+*/
+static void retireTask(Importer importer, struct task_p *task)
+{
+    closeSegment(importer, task);
+    g_hash_table_remove(importer->tasks, GINT_TO_POINTER(task->pid));
+}
+
+/*!
+* A task becomes ready, ending its I/O burst if it was sleeping.
+*
+* Receive param importer The importer
+* Receive param pid Id of the task
+* Receive param prio Kernel priority of the task
+* Receive param time Time of the event
+*/
+static void wakeUp(Importer importer, int pid, int prio, long long time)
+{
+    struct task_p *task = getTask(importer, pid, prio, time);
+    if (task->state != TASK_BLOCKED)
+        return;
+    task->bursts[task->nbursts++] = (int)(time - task->last);
+    task->state = TASK_RUNNABLE;
+}
+
+/*!
+* A task goes on a CPU.
+*
+* Receive param importer The importer
+* Receive param pid Id of the task
+* Receive param prio Kernel priority of the task
+* Receive param time Time of the event
+*/
+static void switchIn(Importer importer, int pid, int prio, long long time)
+{
+    struct task_p *task;
+    if (pid <= 0)
+        return;
+    /* A missing wake up is taken to happen now */
+    wakeUp(importer, pid, prio, time);
+    task = g_hash_table_lookup(importer->tasks, GINT_TO_POINTER(pid));
+    task->state = TASK_RUNNING;
+    task->last = time;
+}
+
+/*!
+* A task leaves a CPU.
+*
+* Receive param importer The importer
+* Receive param pid Id of the task
+* Receive param prio Kernel priority of the task
+* Receive param state First letter of the state it leaves in
+* Receive param time Time of the event
+*/
+static void switchOut(Importer importer, int pid, int prio, char state, long long time)
+{
+    struct task_p *task;
+    if (pid <= 0)
+        return;
+    task = g_hash_table_lookup(importer->tasks, GINT_TO_POINTER(pid));
+    if (task == NULL)
+    {
+        /* It was running before the trace or its segment ended, only a preemption leaves it ready */
+        if (state == 'R')
+            getTask(importer, pid, prio, time);
+        return;
+    }
+    if (task->state == TASK_RUNNING)
+        task->cpu += time - task->last;
+    if (state == 'R')
+    {
+        task->state = TASK_RUNNABLE;
+    }
+    else if (state == 'X' || state == 'Z' || state == 'x')
+    {
+        retireTask(importer, task);
+    }
+    else
+    {
+        task->bursts[task->nbursts++] = (int)task->cpu;
+        task->cpu = 0;
+        task->state = TASK_BLOCKED;
+        task->last = time;
+        /* An I/O and a CPU burst must still fit */
+        if (task->nbursts + 2 > MAX_BURSTS)
+            retireTask(importer, task);
+    }
+}
+
+/*!
+* A task exits.
+*
+* Receive param importer The importer
+* Receive param pid Id of the task
+* Receive param time Time of the event
+*/
+static void exitTask(Importer importer, int pid, long long time)
+{
+    struct task_p *task = g_hash_table_lookup(importer->tasks, GINT_TO_POINTER(pid));
+    if (task == NULL)
+        return;
+    if (task->state == TASK_RUNNING)
+        task->cpu += time - task->last;
+    retireTask(importer, task);
+}
+
+/*!
+* Returns the earliest time a segment not yet finished may start, ending
+* the segments older than the window.
+*
+* Receive param importer The importer
+*
+* return The time, no process arriving later can be handed yet
+*/
+static long long watermark(Importer importer)
+{
+    struct mark_p *mark;
+    struct task_p *task;
+    while ((mark = HeapPeek(importer->marks)) != NULL)
+    {
+        task = g_hash_table_lookup(importer->tasks, GINT_TO_POINTER(mark->pid));
+        if (task != NULL && task->serial == mark->serial)
+        {
+            if (importer->now - mark->start <= importer->window)
+                return mark->start;
+            /* The segment is too old, a sleeping task loses the I/O burst it is in */
+            if (task->state == TASK_BLOCKED)
+            {
+                retireTask(importer, task);
+            }
+            else
+            {
+                if (task->state == TASK_RUNNING)
+                {
+                    task->cpu += importer->now - task->last;
+                    task->last = importer->now;
+                }
+                closeSegment(importer, task);
+                openSegment(importer, task, importer->now);
+            }
+        }
+        HeapPop(importer->marks);
+        free(mark);
+    }
+    return importer->now;
+}
+
+/*!
+* Reads the time of an event in units since the first event.
+*
+* Receive param importer The importer
+* Receive param event Start of the name of the event in the line
+* Receive param time Where the time is written, in units since the first event
+*
+* return 1 if the time was read, 0 if there is none, -1 if it does not fit
+*/
+static int readTime(Importer importer, const char *event, long long *time)
+{
+    long long micro = readMicro(importer->line, event);
+    if (micro < 0)
+        return 0;
+    if (readCpu(importer->line, event) > importer->cpus)
+        importer->cpus = readCpu(importer->line, event);
+    if (importer->first < 0)
+        importer->first = micro;
+    *time = (micro - importer->first) / importer->tick;
+    if (*time < importer->now)
+        *time = importer->now;
+    /*
+     * On one CPU a process finishes before its arrival, its I/O and all the
+     * CPU time. The open segments hold at most a window of CPU time per CPU
+     * and the I/O of a process is shorter than a window.
+     */
+    if (*time + importer->work + importer->window * (importer->cpus + 1) > INT_MAX)
+    {
+        ErrorMsg("ImporterNext", "trace too long for the tick, the rest is ignored");
+        return -1;
+    }
+    return 1;
+}
+
+/*!
+* Reads the number after a key.
+*
+* Receive param text Text after the name of the event
+* Receive param key The key, including the equal sign
+* Receive param value Where the number is written
+*
+* return 1 if the key was found
+*/
+static int readField(const char *text, const char *key, int *value)
+{
+    const char *p = strstr(text, key);
+    if (p == NULL)
+        return 0;
+    *value = atoi(p + strlen(key));
+    return 1;
+}
+
+/*!
+* Reads a task in the short form of perf, "comm:pid [prio]".
+*
+* Receive param text Where the task starts
+* Receive param pid Where the id is written
+* Receive param prio Where the priority is written
+*
+* return Pointer after the priority or NULL if there is no task
+*/
+static const char *readCompact(const char *text, int *pid, int *prio)
+{
+    const char *bracket = strchr(text, '['), *p;
+    if (bracket == NULL)
+        return NULL;
+    for (p = bracket; p > text && p[-1] == ' '; p--)
+        ;
+    while (p > text && p[-1] >= '0' && p[-1] <= '9')
+        p--;
+    if (p == text || p[-1] != ':')
+        return NULL;
+    *pid = atoi(p);
+    *prio = atoi(bracket + 1);
+    p = strchr(bracket, ']');
+    return (p != NULL) ? p + 1 : NULL;
+}
+
+/*!
+* Applies a sched_switch event.
+*
+* Receive param importer The importer
+* Receive param text Text after the name of the event
+* Receive param time Time of the event
+*/
+static void readSwitch(Importer importer, const char *text, long long time)
+{
+    int prevPid, prevPrio = 0, nextPid, nextPrio = 0;
+    const char *p;
+    char state;
+    if (readField(text, "prev_pid=", &prevPid) && readField(text, "next_pid=", &nextPid))
+    {
+        readField(text, "prev_prio=", &prevPrio);
+        readField(text, "next_prio=", &nextPrio);
+        p = strstr(text, "prev_state=");
+        state = (p != NULL) ? p[strlen("prev_state=")] : 'R';
+    }
+    else
+    {
+        /* prev_comm:prev_pid [prev_prio] prev_state ==> next_comm:next_pid [next_prio] */
+        if ((p = readCompact(text, &prevPid, &prevPrio)) == NULL)
+            return;
+        while (*p == ' ')
+            p++;
+        state = *p;
+        if ((p = strstr(p, "==>")) == NULL || readCompact(p + 3, &nextPid, &nextPrio) == NULL)
+            return;
+    }
+    switchOut(importer, prevPid, prevPrio, state, time);
+    switchIn(importer, nextPid, nextPrio, time);
+}
+
+/*!
+* Reads the task of a wake up or exit event.
+*
+* Receive param text Text after the name of the event
+* Receive param pid Where the id is written
+* Receive param prio Where the priority is written
+*
+* return 1 if the task was read
+*/
+static int readTask(const char *text, int *pid, int *prio)
+{
+    *prio = 0;
+    if (readField(text, " pid=", pid))
+    {
+        readField(text, " prio=", prio);
+        return 1;
+    }
+    return readCompact(text, pid, prio) != NULL;
+}
+
+/*!
+* Reads lines until one has an event, and applies it.
+*
+* Receive param importer The importer
+*
+* At the end of the trace every open segment ends.
+*/
+static void readEvent(Importer importer)
+{
+    GHashTableIter iter;
+    gpointer key, value;
+    struct task_p *task;
+    char *event;
+    long long time;
+    int pid, prio, found = 0;
+    while (found >= 0 && fgets(importer->line, MAX_TRACE_LINE, importer->fp) != NULL)
+    {
+        if ((event = findEvent(importer->line)) == NULL || (found = readTime(importer, event, &time)) <= 0)
+            continue;
+        importer->now = time;
+        if (strncmp(event, "sched_switch:", 13) == 0)
+        {
+            readSwitch(importer, event + 13, time);
+        }
+        else if (strncmp(event, "sched_process_exit:", 19) == 0)
+        {
+            if (readTask(event + 19, &pid, &prio))
+                exitTask(importer, pid, time);
+        }
+        else if (readTask(strchr(event, ':') + 1, &pid, &prio) && pid > 0)
+        {
+            wakeUp(importer, pid, prio, time);
+        }
+        return;
+    }
+    /* The tasks still running run until the last event */
+    g_hash_table_iter_init(&iter, importer->tasks);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+        task = value;
+        if (task->state == TASK_RUNNING)
+            task->cpu += importer->now - task->last;
+        closeSegment(importer, task);
+    }
+    g_hash_table_remove_all(importer->tasks);
+    importer->eof = 1;
+}
+
+/*!
+* Returns the tick of an importer.
+*
+* Receive param importer The importer
+*
+* return Microseconds per unit of time, the one given or the one chosen from the trace
+*/
+int ImporterTick(Importer importer)
+{
+    return importer->tick;
+}
+
+/*!
+* Hands the next process of the trace.
+*
+* Receive param importer The importer, as a gpointer so it can be used as a ProcessSource
+*
+* return The next process in arrival order or NULL at the end of the trace
+*/
+Process ImporterNext(gpointer importer)
+{
+    Importer imp = importer;
+    Process process;
+    long long limit; /* No process arriving later can be handed yet */
+    while (1)
+    {
+        /* The old segments are cut after every event, even if no process is ready */
+        limit = watermark(imp);
+        process = HeapPeek(imp->ready);
+        if (process != NULL && (imp->eof || process->process_arrival <= limit))
+            return HeapPop(imp->ready);
+        if (imp->eof)
+            return NULL;
+        readEvent(imp);
+    }
+}
+
+/*!
+* Writes a process as a line of a process file.
+*
+* Receive param fp The file
+* Receive param process The process
+*/
+void WriteProcess(FILE *fp, Process process)
+{
+    int i;
+    fprintf(fp, "%d %d ", process->process_id, process->process_arrival);
+    if (process->process_bursts == NULL)
+        fprintf(fp, "%d", process->process_burst);
+    for (i = 0; i < process->process_nbursts; i++)
+        fprintf(fp, (i == 0) ? "%d" : ",%d", process->process_bursts[i]);
+    fprintf(fp, " %d\n", process->process_priority);
+}
+
+/*!
+* Frees the memory of an importer, the trace is not closed.
+*
+* Receive param importer The importer to destroy
+*/
+void DestroyImporter(Importer importer)
+{
+    g_hash_table_destroy(importer->tasks);
+    DestroyHeap(importer->marks, free);
+    DestroyHeap(importer->ready, freeNode);
+    free(importer);
+}
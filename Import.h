@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Import.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the importer of perf sched and ftrace traces
+ *
+ * Notes:
+ *          Requires glib.h, stdio.h and Process.h to be included first.
+ *
+ */
+
+/* We make a typedef to facilitate declaration of importer_p structures */
+typedef struct importer_p *Importer;
+
+/* Consult documentation or Import.c for more information. */
+Importer CreateImporter(FILE *fp, int tick);
+
+int ImporterTick(Importer importer);
+
+Process ImporterNext(gpointer importer);
+
+void WriteProcess(FILE *fp, Process process);
+
+void DestroyImporter(Importer importer);
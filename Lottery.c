@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Lottery.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Ready queue that draws the next process with probability
+ *          proportional to its tickets.
+ *
+ * References:
+ *          Lottery scheduling (Waldspurger & Weihl). The tickets are kept
+ *          in a Fenwick tree so the winner is found in O(log n).
+ *
+ * Error handling:
+ *          None
+ *
+ * Notes:
+ *          Every process takes a slot of the tree. Drawing a ticket walks
+ *          the tree from the top looking for the slot where the prefix
+ *          sum of tickets passes the number drawn, then the slot is freed
+ *          and reused by the next process added. The random numbers come
+ *          from a GRand with a known seed so a run can be repeated.
+ *
+ */
+#include <stdio.h>   /* Used for the FILE type in Process.h */
+#include <stdlib.h>  /* Used for memory manipulation */
+#include <glib.h>    /* Used for GRand */
+#include "Process.h" /* Used for the data structures */
+#include "Lottery.h" /* Function header */
+
+#define LOTTERY_INITIAL 64 //!< Initial number of slots, must be a power of two.
+
+/* Declaration of the data structure lottery_p that holds the processes and their tickets */
+struct lottery_p
+{
+    Process *slots; /* Process in every slot */
+    int *tickets;   /* Tickets of the process in every slot, 0 if free */
+    gint64 *tree;   /* Fenwick tree of tickets, index 1 is the first slot */
+    int *free;      /* Stack of free slots */
+    int freeCount;  /* Number of slots in the stack */
+    int used;       /* Slots ever used, the ones after it are free */
+    int capacity;   /* Number of slots, always a power of two */
+    int size;       /* Number of processes stored */
+    gint64 total;   /* Sum of all the tickets */
+    GRand *rand;    /* Generator of the tickets drawn */
+};
+
+/*!
+* Adds a value to a slot of the Fenwick tree.
+*
+* Receive param lottery The lottery
+* Receive param slot Slot to change
+* Receive param delta Value added to the slot
+*/
+static void treeAdd(Lottery lottery, int slot, gint64 delta)
+{
+    int i;
+    for (i = slot + 1; i <= lottery->capacity; i += i & -i)
+        lottery->tree[i] += delta;
+}
+
+/*!
+* Doubles the number of slots and builds the tree again.
+*
+* Receive param lottery The lottery
+*/
+static void growLottery(Lottery lottery)
+{
+    int i, parent;
+    lottery->capacity *= 2;
+    lottery->slots = (Process *)realloc(lottery->slots, lottery->capacity * sizeof(Process));
+    lottery->tickets = (int *)realloc(lottery->tickets, lottery->capacity * sizeof(int));
+    lottery->free = (int *)realloc(lottery->free, lottery->capacity * sizeof(int));
+    lottery->tree = (gint64 *)realloc(lottery->tree, (lottery->capacity + 1) * sizeof(gint64));
+    /* The tree is built in O(n) adding every node to its parent */
+    for (i = 1; i <= lottery->capacity; i++)
+        lottery->tree[i] = (i <= lottery->used) ? lottery->tickets[i - 1] : 0;
+    for (i = 1; i <= lottery->capacity; i++)
+    {
+        parent = i + (i & -i);
+        if (parent <= lottery->capacity)
+            lottery->tree[parent] += lottery->tree[i];
+    }
+}
+
+/*!
+* Creates an empty lottery.
+*
+* Receive param seed Seed of the random numbers
+*
+* return Pointer to the new lottery
+*/
+Lottery CreateLottery(guint32 seed)
+{
+    Lottery lottery = (Lottery)calloc(1, sizeof(struct lottery_p));
+    lottery->capacity = LOTTERY_INITIAL;
+    lottery->slots = (Process *)malloc(LOTTERY_INITIAL * sizeof(Process));
+    lottery->tickets = (int *)malloc(LOTTERY_INITIAL * sizeof(int));
+    lottery->free = (int *)malloc(LOTTERY_INITIAL * sizeof(int));
+    lottery->tree = (gint64 *)calloc(LOTTERY_INITIAL + 1, sizeof(gint64));
+    lottery->rand = g_rand_new_with_seed(seed);
+    return lottery;
+}
+
+/*!
+* Restarts the random numbers of a lottery.
+*
+* Receive param lottery The lottery
+* Receive param seed Seed of the random numbers
+*/
+void LotterySeed(Lottery lottery, guint32 seed)
+{
+    g_rand_set_seed(lottery->rand, seed);
+}
+
+/*!
+* Adds a process to the lottery.
+*
+* Receive param lottery The lottery
+* Receive param process The process that becomes ready
+* Receive param tickets Number of tickets of the process, at least 1
+*/
+void LotteryAdd(Lottery lottery, Process process, int tickets)
+{
+    int slot;
+    if (tickets < 1)
+        tickets = 1;
+    /* Free slots are reused before new ones are taken */
+    if (lottery->freeCount > 0)
+    {
+        slot = lottery->free[--lottery->freeCount];
+    }
+    else
+    {
+        if (lottery->used == lottery->capacity)
+            growLottery(lottery);
+        slot = lottery->used++;
+    }
+    lottery->slots[slot] = process;
+    lottery->tickets[slot] = tickets;
+    treeAdd(lottery, slot, tickets);
+    lottery->total += tickets;
+    lottery->size++;
+}
+
+/*!
+* Draws a ticket and removes the process that holds it.
+*
+* Receive param lottery The lottery
+*
+* return The winner or NULL if the lottery is empty
+*
+* The tree is walked from the biggest power of two down, skipping every
+  range whose tickets are not greater than the number drawn.
+*/
+Process LotteryDraw(Lottery lottery)
+{
+    guint64 draw;
+    gint64 target;
+    int position = 0, step, slot;
+    if (lottery->size == 0)
+        return NULL;
+    draw = ((guint64)g_rand_int(lottery->rand) << 32) | g_rand_int(lottery->rand);
+    target = (gint64)(draw % (guint64)lottery->total);
+    for (step = lottery->capacity; step > 0; step >>= 1)
+    {
+        if (position + step <= lottery->capacity && lottery->tree[position + step] <= target)
+        {
+            position += step;
+            target -= lottery->tree[position];
+        }
+    }
+    /* position is the number of slots before the winner */
+    slot = position;
+    treeAdd(lottery, slot, -lottery->tickets[slot]);
+    lottery->total -= lottery->tickets[slot];
+    lottery->tickets[slot] = 0;
+    lottery->free[lottery->freeCount++] = slot;
+    lottery->size--;
+    return lottery->slots[slot];
+}
+
+/*!
+* Returns the number of processes in the lottery.
+*
+* Receive param lottery The lottery
+*
+* return Number of processes stored
+*/
+int LotterySize(Lottery lottery)
+{
+    return lottery->size;
+}
+
+/*!
+* Frees the memory of a lottery.
+*
+* Receive param lottery The lottery to destroy
+* Receive param free_func Function applied to every process left, can be NULL
+*/
+void DestroyLottery(Lottery lottery, GDestroyNotify free_func)
+{
+    int i;
+    if (free_func != NULL)
+        for (i = 0; i < lottery->used; i++)
+            if (lottery->tickets[i] > 0)
+                free_func(lottery->slots[i]);
+    free(lottery->slots);
+    free(lottery->tickets);
+    free(lottery->free);
+    free(lottery->tree);
+    g_rand_free(lottery->rand);
+    free(lottery);
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Lottery.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the ready queue of lottery scheduling
+ *
+ * Notes:
+ *          Requires glib.h and Process.h to be included first.
+ *
+ */
+
+/* We make a typedef to facilitate declaration of lottery_p structures */
+typedef struct lottery_p *Lottery;
+
+/* Consult documentation or Lottery.c for more information. */
+Lottery CreateLottery(guint32 seed);
+
+void LotterySeed(Lottery lottery, guint32 seed);
+
+void LotteryAdd(Lottery lottery, Process process, int tickets);
+
+Process LotteryDraw(Lottery lottery);
+
+int LotterySize(Lottery lottery);
+
+void DestroyLottery(Lottery lottery, GDestroyNotify free_func);
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: MonteCarlo.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Runs the algorithms on many perturbed copies of a workload
+ *          and reports the mean, the standard deviation and the 95%
+ *          confidence interval of their averages.
+ *
+ * Error handling:
+ *          None
+ *
+ * Notes:
+ *          Every replica moves the arrivals by a random jitter, scales
+ *          the cpu bursts by a random noise and, if asked, draws the
+ *          processes with replacement. Each replica has its own seed,
+ *          taken in order from a generator seeded with the seed given,
+ *          so the results do not depend on the number of threads.
+ *
+ *          The replicas are shared by a set of threads that take the
+ *          next one with an atomic counter. Each thread has its own
+ *          random generator, reseeded for every replica, and its own
+ *          arrays to sort the replica, and writes its results to rows
+ *          no other thread touches, so no lock is needed.
+ *
+ */
+#include <stdio.h>      /* Used for printf */
+#include <stdlib.h>     /* Used for memory manipulation */
+#include <math.h>       /* Used for sqrt */
+#include <glib.h>       /* Used for GThread, GRand and the atomic operations */
+#include "Process.h"    /* Used for the data structures */
+#include "RadixSort.h"  /* Used to sort the replicas by arrival */
+#include "Export.h"     /* Required by Simulator.h */
+#include "FairShare.h"  /* Required by Simulator.h */
+#include "Simulator.h"  /* Used to run the algorithms */
+#include "MonteCarlo.h" /* Function header */
+
+#define METRICS 3  //!< Wait, response and turnaround.
+#define T_TABLE 30 //!< Degrees of freedom with their own Student t value.
+
+/* Declaration of the data structure montecarlo_p shared by the threads */
+struct montecarlo_p
+{
+    Process *base;              /* The processes of the workload in arrival order */
+    long n;                     /* Number of processes */
+    int *algorithms;            /* Values of algorithm_type to run */
+    int count;                  /* Number of algorithms */
+    int quantum;                /* Time slice for Round Robin, lottery and stride */
+    int aging;                  /* Aging rate of the priority algorithms */
+    GroupTable groups;          /* Groups of fair share scheduling, can be NULL */
+    struct perturbation_p *perturbation; /* How each replica changes the workload */
+    guint32 *seeds;             /* Seed of every replica */
+    int replicas;               /* Number of replicas */
+    gint next;                  /* Next replica to run, taken atomically */
+    double *results;            /* Averages of every replica, algorithm and metric */
+};
+
+/* Student t for a two sided 95% interval, by degrees of freedom */
+static const double student[T_TABLE] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+/*!
+* Scales the cpu bursts of a process by a random factor.
+*
+* Receive param process The process to change
+* Receive param rng Random generator of the replica
+* Receive param noise Most percent a burst grows or shrinks
+*/
+static void addNoise(Process process, GRand *rng, int noise)
+{
+    double factor;
+    int i, burst;
+    if (process->process_bursts == NULL)
+    {
+        factor = 1.0 + (2.0 * g_rand_double(rng) - 1.0) * noise / 100.0;
+        burst = (int)(process->process_burst * factor + 0.5);
+        process->process_burst = (burst < 1 && process->process_burst > 0) ? 1 : burst;
+        process->process_remainingcycles = process->process_burst;
+        return;
+    }
+    /* Only the cpu bursts change, the I/O is left as it is */
+    process->process_burst = 0;
+    for (i = 0; i < process->process_nbursts; i += 2)
+    {
+        factor = 1.0 + (2.0 * g_rand_double(rng) - 1.0) * noise / 100.0;
+        burst = (int)(process->process_bursts[i] * factor + 0.5);
+        process->process_bursts[i] = (burst < 1 && process->process_bursts[i] > 0) ? 1 : burst;
+        process->process_burst += process->process_bursts[i];
+    }
+    process->process_remainingcycles = process->process_burst;
+}
+
+/*!
+* Builds a replica of the workload sorted by arrival.
+*
+* Receive param mc The shared state
+* Receive param rng Random generator of the replica
+* Receive param items Array of 2 * n items, filled with the processes of the replica
+*/
+static void buildReplica(struct montecarlo_p *mc, GRand *rng, RadixItem *items)
+{
+    struct perturbation_p *perturbation = mc->perturbation;
+    Process process;
+    long i;
+    int delta;
+    for (i = 0; i < mc->n; i++)
+    {
+        if (perturbation->resample)
+        {
+            process = copyFunction(mc->base[g_rand_int_range(rng, 0, (gint32)mc->n)], NULL);
+            process->process_id = (int)i + 1;
+        }
+        else
+        {
+            process = copyFunction(mc->base[i], NULL);
+        }
+        if (perturbation->jitter > 0)
+        {
+            delta = g_rand_int_range(rng, -perturbation->jitter, perturbation->jitter + 1);
+            if (process->process_arrival + delta < 0)
+                delta = -process->process_arrival;
+            process->process_arrival += delta;
+            if (process->process_deadline != NO_DEADLINE)
+                process->process_deadline += delta;
+        }
+        if (perturbation->noise > 0)
+            addNoise(process, rng, perturbation->noise);
+        items[i].key = RADIX_KEY(process->process_arrival);
+        items[i].data = process;
+    }
+    RadixSort(items, items + mc->n, mc->n, 4);
+}
+
+/*!
+* Body of the threads, runs replicas until there are no more.
+*
+* Receive param data The shared state
+*
+* return NULL
+*/
+static gpointer replicaThread(gpointer data)
+{
+    struct montecarlo_p *mc = data;
+    GRand *rng = g_rand_new_with_seed(0);
+    RadixItem *items = (RadixItem *)malloc(2 * (mc->n > 0 ? mc->n : 1) * sizeof(RadixItem));
+    Simulator sim;
+    double *row;
+    long i;
+    int replica, a;
+    while ((replica = g_atomic_int_add(&mc->next, 1)) < mc->replicas)
+    {
+        g_rand_set_seed(rng, mc->seeds[replica]);
+        buildReplica(mc, rng, items);
+        for (a = 0; a < mc->count; a++)
+        {
+            sim = CreateSimulator(mc->algorithms[a], mc->quantum);
+            SimulatorSetSeed(sim, mc->seeds[replica]);
+            SimulatorSetAging(sim, mc->aging);
+            SimulatorSetGroups(sim, mc->groups);
+            /* The last algorithm takes the replica itself */
+            for (i = 0; i < mc->n; i++)
+                SimulatorArrive(sim, (a < mc->count - 1) ? copyFunction(items[i].data, NULL) : items[i].data);
+            SimulatorFinish(sim);
+            row = mc->results + ((long)replica * mc->count + a) * METRICS;
+            SimulatorAverages(sim, &row[0], &row[1], &row[2]);
+            DestroySimulator(sim);
+        }
+    }
+    free(items);
+    g_rand_free(rng);
+    return NULL;
+}
+
+/*!
+* Prints the mean, standard deviation and confidence interval of a metric.
+*
+* Receive param mc The shared state with the results
+* Receive param a Index of the algorithm
+* Receive param metric Index of the metric
+* Receive param name Name of the metric
+*/
+static void printMetric(struct montecarlo_p *mc, int a, int metric, char *name)
+{
+    double sum = 0.0, sum2 = 0.0, mean, deviation = 0.0, margin = 0.0, value;
+    int r;
+    for (r = 0; r < mc->replicas; r++)
+    {
+        value = mc->results[((long)r * mc->count + a) * METRICS + metric];
+        sum += value;
+        sum2 += value * value;
+    }
+    mean = sum / mc->replicas;
+    if (mc->replicas > 1)
+    {
+        value = (sum2 - sum * mean) / (mc->replicas - 1);
+        deviation = value > 0.0 ? sqrt(value) : 0.0;
+        margin = (mc->replicas - 1 <= T_TABLE ? student[mc->replicas - 2] : 1.96) * deviation / sqrt(mc->replicas);
+    }
+    printf("Monte Carlo %s time for %s Algorithm : mean %f stddev %f 95%% CI %f %f\n", name,
+           AlgorithmName(mc->algorithms[a]), mean, deviation, mean - margin, mean + margin);
+}
+
+/*!
+* Runs the algorithms on perturbed replicas of a workload and prints
+* the statistics of their averages.
+*
+* Receive param processes List of processes sorted by arrival, it is not changed
+* Receive param algorithms Values of algorithm_type to run
+* Receive param count Number of algorithms
+* Receive param quantum Time slice for Round Robin, lottery and stride
+* Receive param seed Seed of the replicas, the same seed repeats the results
+* Receive param aging Aging rate of the priority algorithms, 0 for none
+* Receive param groups Groups of fair share scheduling, can be NULL
+* Receive param replicas Number of replicas
+* Receive param perturbation How each replica changes the workload
+*/
+void MonteCarlo(GList *processes, int *algorithms, int count, int quantum, guint32 seed, int aging,
+                GroupTable groups, int replicas, struct perturbation_p *perturbation)
+{
+    struct montecarlo_p mc;
+    GThread **threads;
+    GRand *master;
+    GList *l;
+    int nthreads, i;
+
+    if (replicas <= 0 || count <= 0)
+        return;
+    mc.n = g_list_length(processes);
+    mc.base = (Process *)malloc((mc.n > 0 ? mc.n : 1) * sizeof(Process));
+    for (l = processes, i = 0; l != NULL; l = l->next, i++)
+        mc.base[i] = l->data;
+    mc.algorithms = algorithms;
+    mc.count = count;
+    mc.quantum = quantum;
+    mc.aging = aging;
+    mc.groups = groups;
+    mc.perturbation = perturbation;
+    mc.replicas = replicas;
+    mc.next = 0;
+    mc.results = (double *)malloc((long)replicas * count * METRICS * sizeof(double));
+    /* The seeds are drawn in order so they do not depend on the threads */
+    mc.seeds = (guint32 *)malloc(replicas * sizeof(guint32));
+    master = g_rand_new_with_seed(seed);
+    for (i = 0; i < replicas; i++)
+        mc.seeds[i] = g_rand_int(master);
+    g_rand_free(master);
+
+    nthreads = (int)g_get_num_processors();
+    if (nthreads > replicas)
+        nthreads = replicas;
+    if (nthreads < 1)
+        nthreads = 1;
+    threads = (GThread **)malloc(nthreads * sizeof(GThread *));
+    for (i = 0; i < nthreads; i++)
+        threads[i] = g_thread_new("replica", replicaThread, &mc);
+    for (i = 0; i < nthreads; i++)
+        g_thread_join(threads[i]);
+    free(threads);
+
+    printf("Monte Carlo replicas : %d\n", replicas);
+    for (i = 0; i < count; i++)
+    {
+        printMetric(&mc, i, 0, "wait");
+        printMetric(&mc, i, 1, "response");
+        printMetric(&mc, i, 2, "turnaround");
+    }
+    free(mc.seeds);
+    free(mc.results);
+    free(mc.base);
+}
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: MonteCarlo.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the Monte Carlo runs over perturbed copies
+ *          of a workload
+ *
+ * Notes:
+ *          Requires glib.h, stdio.h, Process.h and FairShare.h to be included
+ *          first.
+ *
+ */
+
+/* Declaration of the data structure perturbation_p with how each replica changes the workload */
+struct perturbation_p
+{
+  int jitter;   /* Most time units an arrival moves, earlier or later */
+  int noise;    /* Most percent a cpu burst grows or shrinks */
+  int resample; /* 1 to draw the processes with replacement */
+};
+
+/* Consult documentation or MonteCarlo.c for more information. */
+void MonteCarlo(GList *processes, int *algorithms, int count, int quantum, guint32 seed, int aging,
+                GroupTable groups, int replicas, struct perturbation_p *perturbation);
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Pipeline.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Parses a process file in its own thread while the simulator
+ *          consumes the processes already parsed.
+ *
+ * Error handling:
+ *          None
+ *
+ * Notes:
+ *          The parser thread takes the processes from a source, usually
+ *          a reader of the file, and pushes every one into a lock-free ring. The simulator pops them
+ *          as its arrival stream, so parsing and scheduling overlap on
+ *          two cores. When the ring is full the parser waits, so no more
+ *          than capacity processes are parsed ahead of the simulator.
+ *          The file must be in arrival order, like in the online mode, so
+ *          the source is expected to check it.
+ *
+ */
+#include <stdio.h>      /* Used for FILE */
+#include <stdlib.h>     /* Used for memory manipulation */
+#include <glib.h>       /* Used for GThread */
+#include "Process.h"    /* Used for the data structures */
+#include "Ring.h"       /* Used to hand the processes to the simulator */
+#include "Export.h"     /* Required by Simulator.h */
+#include "FairShare.h"  /* Required by Simulator.h */
+#include "Simulator.h"  /* Used for ProcessSource */
+#include "Pipeline.h"   /* Function header */
+
+/* Declaration of the data structure pipeline_p with the parser and its ring */
+struct pipeline_p
+{
+    ProcessSource source; /* Hands the processes of the file */
+    gpointer data;        /* Argument of the source */
+    Ring ring;            /* Processes parsed and not yet simulated */
+    GThread *parser;      /* Thread that reads the file */
+};
+
+/*!
+* Body of the parser thread, pushes every process of the source.
+*
+* Receive param data The pipeline
+*
+* return NULL
+*/
+static gpointer parserThread(gpointer data)
+{
+    Pipeline pipeline = data;
+    Process process;
+    while ((process = pipeline->source(pipeline->data)) != NULL)
+        RingPushWait(pipeline->ring, process);
+    RingClose(pipeline->ring);
+    return NULL;
+}
+
+/*!
+* Starts parsing a process file.
+*
+* Receive param source Hands the processes of the file, called from the parser thread
+* Receive param data Argument of the source
+* Receive param capacity Most processes parsed ahead of the simulator
+*
+* return Pointer to the pipeline
+*/
+Pipeline CreatePipeline(ProcessSource source, gpointer data, int capacity)
+{
+    Pipeline pipeline = (Pipeline)malloc(sizeof(struct pipeline_p));
+    pipeline->source = source;
+    pipeline->data = data;
+    pipeline->ring = CreateRing(capacity);
+    pipeline->parser = g_thread_new("parser", parserThread, pipeline);
+    return pipeline;
+}
+
+/*!
+* Returns the next process of the file.
+*
+* Receive param pipeline The pipeline, as a gpointer so it can be used as a ProcessSource
+*
+* return The process, waiting for the parser if needed, or NULL at the end of the file
+*/
+Process PipelineNext(gpointer pipeline)
+{
+    Pipeline p = pipeline;
+    return RingPopWait(p->ring);
+}
+
+/*!
+* Waits for the parser and frees the memory of a pipeline.
+*
+* Receive param pipeline The pipeline to destroy, the source is not closed
+*
+* The processes that were not consumed are freed, so the pipeline may
+  be destroyed once the simulator has every process it needs.
+*/
+void DestroyPipeline(Pipeline pipeline)
+{
+    Process process;
+    /* The parser may be waiting for room in the ring */
+    while ((process = RingPopWait(pipeline->ring)) != NULL)
+        freeNode(process);
+    g_thread_join(pipeline->parser);
+    DestroyRing(pipeline->ring, NULL);
+    free(pipeline);
+}
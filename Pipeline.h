@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Pipeline.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the parser thread that feeds the simulator
+ *
+ * Notes:
+ *          Requires glib.h, stdio.h, Process.h and Simulator.h to be included
+ *          first.
+ *
+ */
+
+/* We make a typedef to facilitate declaration of pipeline_p structures */
+typedef struct pipeline_p *Pipeline;
+
+/* Consult documentation or Pipeline.c for more information. */
+Pipeline CreatePipeline(ProcessSource source, gpointer data, int capacity);
+
+Process PipelineNext(gpointer pipeline);
+
+void DestroyPipeline(Pipeline pipeline);
@@ -15,8 +15,16 @@
  */
 #include <stdio.h>   /*Used for input and output manipulation (printf)*/
 #include <stdlib.h>  /*Used for memory manipulation*/
+#include <string.h>  /*Used for memcpy*/
 #include <glib.h>    /*Used so we can use the GList double linked list*/
+#include "FileIO.h"  /*Used to read the fields of a line*/
 #include "Process.h" /*Used to access data structures and enums*/
+#include "RadixSort.h" /*Used to sort big lists*/
+
+#define RADIX_MIN 512        //!< Length from which lists are sorted with a radix sort.
+#define NUMVAL 4             //!< Number of fields that describe a process.
+#define MAXFIELDS 6          //!< Fields with the optional deadline and group.
+#define MAX_LINE_VALUES 4096 //!< Most numbers read in a line.
 
 /*
 * Creates a process and adds it to the process list.
@@ -38,6 +46,23 @@
 */
 
 GList *CreateProcess(GList *process_list, int id, int arrival, int burst, int priority, int algo)
+{
+    /* The process is created and the new GList header is returned */
+    return g_list_insert(process_list, NewProcess(id, arrival, burst, priority), -1);
+}
+
+/*
+* Creates a process without adding it to any list.
+* @param id The process id number
+* @param Arrival The process Arrival Time
+* @param Burst The process CPU Burst
+* @param Priority The process Priority
+* return Pointer to the new process
+*
+* Used by the dispatchers that receive processes one at a time
+  instead of reading the whole file into a list.
+*/
+Process NewProcess(int id, int arrival, int burst, int priority)
 {
     /* Memory is allocated for our new process */
     Process node = (Process)malloc(sizeof(struct process_p));
@@ -49,8 +74,98 @@ GList *CreateProcess(GList *process_list, int id, int arrival, int burst, int pr
     node->process_runtime = 0;
     node->process_lastruntime = 0;
     node->process_remainingcycles = burst;
-    /* The new GList header is returned */
-    return g_list_insert(process_list, node, -1);
+    node->process_starttime = -1;
+    node->process_sequence = 0;
+    node->process_pass = 0;
+    node->process_deadline = NO_DEADLINE;
+    node->process_bursts = NULL;
+    node->process_nbursts = 0;
+    node->process_phase = 0;
+    node->process_iotime = 0;
+    node->process_wake = 0;
+    node->process_group = 0;
+    return node;
+}
+
+/*
+* Reads the next process of a file.
+* @param fp File positioned after the quantum
+* return Pointer to the new process or NULL at the end of the file
+*
+* A line has the fields id, arrival, burst, priority, an optional
+  deadline relative to the arrival and an optional group. A negative
+  deadline means the process has none, so a group can be given alone. The burst can be a list of numbers
+  separated by commas that alternate CPU and I/O bursts, "3,4,2" runs
+  3 units, waits 4 units for I/O and runs 2 more units. A list that ends
+  with an I/O burst has it ignored. Lines with less than four fields are
+  skipped, and so are lines with a negative arrival or burst, as time
+  could go backwards. The burst of the process is the total of its CPU
+  bursts.
+*/
+Process ReadProcess(FILE *fp)
+{
+    int values[MAX_LINE_VALUES]; /* Numbers in the line */
+    int joined[MAX_LINE_VALUES]; /* 1 for the numbers that follow a comma */
+    int start[MAXFIELDS];        /* Position in values of every field */
+    int length[MAXFIELDS];       /* Numbers in every field */
+    int count, fields, i, cpu;
+    Process node;
+
+    while ((count = GetFields(fp, values, joined, MAX_LINE_VALUES)) >= 0)
+    {
+        /* The numbers are grouped in fields */
+        fields = 0;
+        for (i = 0; i < count; i++)
+        {
+            if (i > 0 && joined[i] && fields > 0)
+            {
+                length[fields - 1]++;
+            }
+            else if (fields < MAXFIELDS)
+            {
+                start[fields] = i;
+                length[fields] = 1;
+                fields++;
+            }
+            else
+            {
+                break;
+            }
+        }
+        if (fields < NUMVAL)
+            continue;
+        for (i = 0; i < length[2] && values[start[2] + i] >= 0; i++)
+            ;
+        if (values[start[1]] < 0 || i < length[2])
+        {
+            WarningMsg("ReadProcess", "negative arrival or burst, the line is skipped");
+            continue;
+        }
+        node = NewProcess(values[start[0]], values[start[1]], values[start[2]], values[start[3]]);
+        if (fields > NUMVAL && values[start[4]] >= 0)
+            node->process_deadline = node->process_arrival + values[start[4]];
+        if (fields > NUMVAL + 1 && values[start[5]] > 0)
+            node->process_group = values[start[5]];
+        /* A list of bursts always ends with a CPU burst */
+        if (length[2] > 1)
+        {
+            node->process_nbursts = (length[2] % 2 == 1) ? length[2] : length[2] - 1;
+            node->process_bursts = (int *)malloc(node->process_nbursts * sizeof(int));
+            cpu = 0;
+            for (i = 0; i < node->process_nbursts; i++)
+            {
+                node->process_bursts[i] = values[start[2] + i];
+                if (i % 2 == 0)
+                    cpu += node->process_bursts[i];
+                else
+                    node->process_iotime += node->process_bursts[i];
+            }
+            node->process_burst = cpu;
+            node->process_remainingcycles = cpu;
+        }
+        return node;
+    }
+    return NULL;
 }
 
 /*
@@ -144,6 +259,56 @@ gint sortFunctionCpuBurst(gpointer a, gpointer b)
     return compare;
 }
 
+/*
+* The Function Sorts a big process list with a radix sort.
+*
+* Receive param process_list Pointer to the GList that's the head of the list
+* Receive param sort Integer value representing what type of sort to apply
+*
+* return Pointer to the new head of the GList that was sorted
+*
+* The key of every node is copied to an array with the node, the array
+  is sorted and the nodes are linked again in the new order. Ties are
+  broken by ID like the sort functions, and ARRIVAL keeps the order of
+  the list like g_list_sort.
+*/
+GList *radixSortList(GList *process_list, int sort)
+{
+    long n = g_list_length(process_list), i;
+    RadixItem *items = (RadixItem *)malloc(n * sizeof(RadixItem));
+    RadixItem *temp = (RadixItem *)malloc(n * sizeof(RadixItem));
+    int bytes = 8;
+    GList *l, *node;
+    /* The key is built from the fields used by the sort functions */
+    for (l = process_list, i = 0; l != NULL; l = l->next, i++)
+    {
+        Process p = l->data;
+        items[i].data = l;
+        if (sort == ID)
+            items[i].key = RADIX_KEY(p->process_id);
+        else if (sort == ARRIVAL)
+            items[i].key = RADIX_KEY(p->process_arrival);
+        else if (sort == PRIORITY)
+            items[i].key = RADIX_KEY(p->process_priority) << 32 | RADIX_KEY(p->process_id);
+        else
+            items[i].key = RADIX_KEY(p->process_remainingcycles) << 32 | RADIX_KEY(p->process_id);
+    }
+    if (sort == ID || sort == ARRIVAL)
+        bytes = 4;
+    RadixSort(items, temp, n, bytes);
+    /* The nodes are linked again in the sorted order */
+    for (i = 0; i < n; i++)
+    {
+        node = items[i].data;
+        node->prev = (i > 0) ? items[i - 1].data : NULL;
+        node->next = (i + 1 < n) ? items[i + 1].data : NULL;
+    }
+    process_list = items[0].data;
+    free(items);
+    free(temp);
+    return process_list;
+}
+
 /*
 * The Function Sorts a process list.
 *
@@ -152,9 +317,14 @@ gint sortFunctionCpuBurst(gpointer a, gpointer b)
 *
 * return Pointer to the new head of the GList that was sorted
 *
+* Big lists are sorted with radixSortList, small ones with g_list_sort
+  as the array is not worth it for them.
 */
 GList *SortProcessList(GList *process_list, int sort)
 {
+    /* Big lists use the radix sort */
+    if (g_list_length(process_list) >= RADIX_MIN)
+        return radixSortList(process_list, sort);
     /* A sort is applied bases on the variable sort */
     if (sort == ID)
         return g_list_sort(process_list, (GCompareFunc)sortFunctionID);
@@ -208,6 +378,21 @@ Process copyFunction(gpointer src, gpointer data)
     copy->process_runtime = original->process_runtime;
     copy->process_lastruntime = original->process_lastruntime;
     copy->process_remainingcycles = original->process_remainingcycles;
+    copy->process_starttime = original->process_starttime;
+    copy->process_sequence = original->process_sequence;
+    copy->process_pass = original->process_pass;
+    copy->process_deadline = original->process_deadline;
+    copy->process_nbursts = original->process_nbursts;
+    copy->process_phase = original->process_phase;
+    copy->process_iotime = original->process_iotime;
+    copy->process_wake = original->process_wake;
+    copy->process_group = original->process_group;
+    copy->process_bursts = NULL;
+    if (original->process_bursts != NULL)
+    {
+        copy->process_bursts = (int *)malloc(original->process_nbursts * sizeof(int));
+        memcpy(copy->process_bursts, original->process_bursts, original->process_nbursts * sizeof(int));
+    }
     /* The new pointer is returned */
     return copy;
 }
@@ -236,6 +421,10 @@ GList *CopyList(GList *process_list)
 */
 void freeNode(gpointer node)
 {
+    Process process = node;
+    /* The list of bursts is deallocated before the process */
+    if (process != NULL)
+        free(process->process_bursts);
     /* Memory is deallocated from the pointer */
     free(node);
 }
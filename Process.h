@@ -13,6 +13,9 @@
  *
  */
 
+/* Value of process_deadline for processes without a deadline */
+#define NO_DEADLINE -1
+
 /* We make a typedef to facilitate declaration of process_p structures in the future */
 typedef struct process_p *Process;
 
@@ -28,6 +31,16 @@ struct process_p
   int process_runtime;         /* The total time the process has run */
   int process_lastruntime;     /* The last time the process started execution */
   int process_remainingcycles; /* The cpu burst left in the process */
+  int process_starttime;       /* The first time the process started execution, -1 if never */
+  long long process_sequence;  /* Order in which the process entered the ready queue */
+  long long process_pass;      /* Pass value of stride scheduling or aged priority key */
+  int process_deadline;        /* Absolute deadline of the process or NO_DEADLINE */
+  int *process_bursts;         /* CPU and I/O bursts alternated, NULL for a single CPU burst */
+  int process_nbursts;         /* Number of values in process_bursts */
+  int process_phase;           /* Index in process_bursts of the current CPU burst */
+  int process_iotime;          /* Total time the process spends in I/O */
+  int process_wake;            /* Time the current I/O burst ends */
+  int process_group;           /* Group of the process for fair share scheduling, 0 is the root */
 };
 
 /* We declare an enum to facilitate the use of
@@ -43,13 +56,47 @@ enum sort_type
   CPUBURST /* Constant for Cpu burst */
 };
 
+/* Algorithms the event driven simulator knows how to run */
+enum algorithm_type
+{
+  FCFS /* First Come First Served */
+  ,
+  NP_PRIORITY /* NonPreemptive Priority */
+  ,
+  NP_SJF /* NonPreemptive Shortest Job First */
+  ,
+  P_PRIORITY /* Preemptive Priority */
+  ,
+  P_SJF /* Preemptive Shortest Job First */
+  ,
+  ROUNDROBIN /* Round Robin */
+  ,
+  LOTTERY /* Lottery scheduling, tickets come from the priority */
+  ,
+  STRIDE /* Stride scheduling, tickets come from the priority */
+  ,
+  NP_EDF /* NonPreemptive Earliest Deadline First */
+  ,
+  P_EDF /* Preemptive Earliest Deadline First */
+  ,
+  FAIR_SHARE /* Hierarchical fair share between groups of processes */
+  ,
+  NUM_ALGORITHMS /* Number of algorithms, not an algorithm */
+};
+
 /* Consult documentation or Process.c for more information. */
+Process NewProcess(int id, int arrival, int burst, int priority);
+
+Process ReadProcess(FILE *fp);
+
 GList *CreateProcess(GList *process_list, int id, int arrival, int burst, int priority, int algo);
 
 GList *SortProcessList(GList *process_list, int sort);
 
 void PrintProcessList(GList *process_list);
 
+Process copyFunction(gpointer src, gpointer data);
+
 GList *CopyList(GList *process_list);
 
 void freeNode(gpointer node);
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: RadixSort.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Stable LSD radix sort used for large process lists
+ *
+ * References:
+ *          Least significant digit radix sort with one byte per pass.
+ *
+ * Error handling:
+ *          None
+ *
+ * Notes:
+ *          The keys are copied next to a pointer in a contiguous array
+ *          so every pass walks memory in order instead of following the
+ *          links of a GList. Passes where all the keys share the same
+ *          byte are skipped. Big arrays are split between threads: each
+ *          thread counts the digits of its part and then writes its part
+ *          to the offsets it was given, which keeps the sort stable.
+ *
+ */
+#include <string.h>      /* Used for memcpy and memset */
+#include <glib.h>        /* Used for GThread */
+#include "RadixSort.h"   /* Function header */
+
+#define RADIX_BUCKETS 256        //!< Values a byte can take.
+#define RADIX_PARALLEL (1 << 20) //!< Items from which the sort uses threads.
+#define RADIX_THREADS 8          //!< Maximum number of threads used.
+
+/* Declaration of the data structure radix_task with the part of the array of one thread */
+struct radix_task
+{
+    RadixItem *src;              /* Array read in this pass */
+    RadixItem *dst;              /* Array written in this pass */
+    long start;                  /* First item of the part */
+    long end;                    /* Item after the last one of the part */
+    int shift;                   /* Position of the byte used in this pass */
+    long count[RADIX_BUCKETS];   /* Items of the part with each byte value */
+    long offset[RADIX_BUCKETS];  /* Where the next item with each byte value goes */
+};
+
+/*!
+* Counts the byte values of a part of the array.
+*
+* Receive param data Pointer to the radix_task
+*
+* return NULL, used as a GThreadFunc
+*/
+static gpointer countDigits(gpointer data)
+{
+    struct radix_task *task = data;
+    long i;
+    memset(task->count, 0, sizeof(task->count));
+    for (i = task->start; i < task->end; i++)
+        task->count[(task->src[i].key >> task->shift) & 0xff]++;
+    return NULL;
+}
+
+/*!
+* Moves a part of the array to its place for the current byte.
+*
+* Receive param data Pointer to the radix_task
+*
+* return NULL, used as a GThreadFunc
+*/
+static gpointer scatterDigits(gpointer data)
+{
+    struct radix_task *task = data;
+    long i;
+    for (i = task->start; i < task->end; i++)
+        task->dst[task->offset[(task->src[i].key >> task->shift) & 0xff]++] = task->src[i];
+    return NULL;
+}
+
+/*!
+* Runs a function on every task, using one thread per task.
+*
+* Receive param func Function to run
+* Receive param tasks Array of tasks
+* Receive param threads Number of tasks
+*
+* The first task runs in the calling thread.
+*/
+static void runTasks(GThreadFunc func, struct radix_task *tasks, int threads)
+{
+    GThread *workers[RADIX_THREADS];
+    int t;
+    for (t = 1; t < threads; t++)
+        workers[t] = g_thread_new("radix", func, &tasks[t]);
+    func(&tasks[0]);
+    for (t = 1; t < threads; t++)
+        g_thread_join(workers[t]);
+}
+
+/*!
+* Sorts an array of items by key keeping the order of equal keys.
+*
+* Receive param items Array to sort
+* Receive param temp Array of the same size used as scratch space
+* Receive param n Number of items
+* Receive param bytes Number of low bytes of the key that are used
+*/
+void RadixSort(RadixItem *items, RadixItem *temp, long n, int bytes)
+{
+    struct radix_task tasks[RADIX_THREADS];
+    RadixItem *src = items, *dst = temp, *swap;
+    int threads = 1, pass, digit, t, skip;
+    long position, total;
+
+    /* Only big arrays are worth the cost of creating threads */
+    if (n >= RADIX_PARALLEL)
+    {
+        threads = g_get_num_processors();
+        if (threads > RADIX_THREADS)
+            threads = RADIX_THREADS;
+        if (threads < 1)
+            threads = 1;
+    }
+    for (t = 0; t < threads; t++)
+    {
+        tasks[t].start = n * t / threads;
+        tasks[t].end = n * (t + 1) / threads;
+    }
+    for (pass = 0; pass < bytes; pass++)
+    {
+        for (t = 0; t < threads; t++)
+        {
+            tasks[t].src = src;
+            tasks[t].dst = dst;
+            tasks[t].shift = 8 * pass;
+        }
+        runTasks(countDigits, tasks, threads);
+        /* Each thread writes its items after those of the previous threads */
+        position = 0;
+        skip = 0;
+        for (digit = 0; digit < RADIX_BUCKETS; digit++)
+        {
+            total = 0;
+            for (t = 0; t < threads; t++)
+            {
+                tasks[t].offset[digit] = position;
+                position += tasks[t].count[digit];
+                total += tasks[t].count[digit];
+            }
+            if (total == n)
+                skip = 1; /* Every key has this byte, the pass changes nothing */
+        }
+        if (skip)
+            continue;
+        runTasks(scatterDigits, tasks, threads);
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+    /* The result may have ended in the scratch array */
+    if (src != items)
+        memcpy(items, src, n * sizeof(RadixItem));
+}
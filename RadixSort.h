@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: RadixSort.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the radix sort of integer keys
+ *
+ * Notes:
+ *          Requires glib.h to be included first.
+ *
+ */
+
+/* Declaration of the data structure radix_item, a key and the element it belongs to */
+struct radix_item
+{
+  guint64 key;   /* Unsigned key, smaller keys go first */
+  gpointer data; /* Element that owns the key */
+};
+
+/* We make a typedef to facilitate declaration of radix_item arrays */
+typedef struct radix_item RadixItem;
+
+/* Turns a signed integer into an unsigned key with the same order */
+#define RADIX_KEY(value) ((guint64)((guint32)(value) ^ 0x80000000u))
+
+/* Consult documentation or RadixSort.c for more information. */
+void RadixSort(RadixItem *items, RadixItem *temp, long n, int bytes);
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Ring.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Bounded ring of pointers that one thread fills while another
+ *          one empties it, without locks.
+ *
+ * Error handling:
+ *          None
+ *
+ * Notes:
+ *          Only the producer writes the tail and only the consumer
+ *          writes the head, so each side publishes its position with an
+ *          atomic store and reads the other one with an atomic load. The
+ *          store of the tail happens after the slot is written, so the
+ *          consumer never sees a slot before its pointer. The positions
+ *          are kept in separate cache lines so the two threads do not
+ *          invalidate each other on every operation. A full ring makes
+ *          the producer wait, which bounds the memory used.
+ *
+ */
+#include <stdlib.h> /* Used for memory manipulation */
+#include <glib.h>   /* Used for the atomic operations and g_thread_yield */
+#include "Ring.h"   /* Function header */
+
+#define CACHE_LINE 64   //!< Bytes that keep the positions apart.
+#define SPIN_LIMIT 128  //!< Failed attempts before a waiting thread yields.
+
+/* Declaration of the data structure ring_p with the slots and the positions */
+struct ring_p
+{
+    gpointer *slots;                        /* Array of capacity pointers */
+    guint mask;                             /* Capacity minus one, the capacity is a power of two */
+    char padding1[CACHE_LINE];
+    gint head;                              /* Next slot to read, written by the consumer */
+    char padding2[CACHE_LINE - sizeof(gint)];
+    gint tail;                              /* Next slot to write, written by the producer */
+    char padding3[CACHE_LINE - sizeof(gint)];
+    gint closed;                            /* 1 once the producer will not push more */
+};
+
+/*!
+* Creates an empty ring.
+*
+* Receive param capacity Minimum number of slots, rounded up to a power of two
+*
+* return Pointer to the new ring
+*/
+Ring CreateRing(int capacity)
+{
+    Ring ring = (Ring)calloc(1, sizeof(struct ring_p));
+    guint size = 1;
+    while (size < (guint)capacity)
+        size <<= 1;
+    ring->slots = (gpointer *)malloc(size * sizeof(gpointer));
+    ring->mask = size - 1;
+    return ring;
+}
+
+/*!
+* Adds a pointer at the tail, only called by the producer.
+*
+* Receive param ring The ring
+* Receive param data The pointer to add
+*
+* return 1 if it was added, 0 if the ring is full
+*/
+int RingPush(Ring ring, gpointer data)
+{
+    guint tail = (guint)ring->tail;
+    guint head = (guint)g_atomic_int_get(&ring->head);
+    if (tail - head > ring->mask)
+        return 0;
+    ring->slots[tail & ring->mask] = data;
+    g_atomic_int_set(&ring->tail, (gint)(tail + 1));
+    return 1;
+}
+
+/*!
+* Removes the pointer at the head, only called by the consumer.
+*
+* Receive param ring The ring
+*
+* return The oldest pointer or NULL if the ring is empty
+*/
+gpointer RingPop(Ring ring)
+{
+    guint head = (guint)ring->head;
+    guint tail = (guint)g_atomic_int_get(&ring->tail);
+    gpointer data;
+    if (head == tail)
+        return NULL;
+    data = ring->slots[head & ring->mask];
+    g_atomic_int_set(&ring->head, (gint)(head + 1));
+    return data;
+}
+
+/*!
+* Waits a little before trying again.
+*
+* Receive param spins Failed attempts so far, it is incremented
+*
+* The thread spins for a while and then gives the CPU away, so a
+  machine with one core does not stall.
+*/
+static void backOff(int *spins)
+{
+    if (*spins < SPIN_LIMIT)
+        (*spins)++;
+    else
+        g_thread_yield();
+}
+
+/*!
+* Adds a pointer at the tail waiting while the ring is full.
+*
+* Receive param ring The ring
+* Receive param data The pointer to add
+*/
+void RingPushWait(Ring ring, gpointer data)
+{
+    int spins = 0;
+    while (!RingPush(ring, data))
+        backOff(&spins);
+}
+
+/*!
+* Removes the pointer at the head waiting while the ring is empty.
+*
+* Receive param ring The ring
+*
+* return The oldest pointer or NULL once the ring is empty and closed
+*/
+gpointer RingPopWait(Ring ring)
+{
+    gpointer data;
+    int spins = 0;
+    while ((data = RingPop(ring)) == NULL)
+    {
+        /* The producer may have pushed its last pointers before closing */
+        if (g_atomic_int_get(&ring->closed))
+            return RingPop(ring);
+        backOff(&spins);
+    }
+    return data;
+}
+
+/*!
+* Tells the consumer that no more pointers will be added.
+*
+* Receive param ring The ring
+*/
+void RingClose(Ring ring)
+{
+    g_atomic_int_set(&ring->closed, 1);
+}
+
+/*!
+* Frees the memory of a ring.
+*
+* Receive param ring The ring to destroy, no thread may be using it
+* Receive param free_func Function applied to every pointer left, can be NULL
+*/
+void DestroyRing(Ring ring, GDestroyNotify free_func)
+{
+    gpointer data;
+    if (free_func != NULL)
+        while ((data = RingPop(ring)) != NULL)
+            free_func(data);
+    free(ring->slots);
+    free(ring);
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Ring.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the lock-free ring shared by one producer
+ *          thread and one consumer thread
+ *
+ * Notes:
+ *          Requires glib.h to be included first.
+ *
+ */
+
+/* We make a typedef to facilitate declaration of ring_p structures */
+typedef struct ring_p *Ring;
+
+/* Consult documentation or Ring.c for more information. */
+Ring CreateRing(int capacity);
+
+int RingPush(Ring ring, gpointer data);
+
+gpointer RingPop(Ring ring);
+
+void RingPushWait(Ring ring, gpointer data);
+
+gpointer RingPopWait(Ring ring);
+
+void RingClose(Ring ring);
+
+void DestroyRing(Ring ring, GDestroyNotify free_func);
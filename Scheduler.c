@@ -16,6 +16,87 @@
  *
  *          schedule file.txt
  *
+ *          schedule -online algorithm [-report interval] [file.txt]
+ *
+ *          The online mode reads the processes from the file or from
+ *          the standard input as they are written and prints every
+ *          dispatch, preemption and finish as soon as it is decided.
+ *          The algorithm is one of FCFS, NPP, NPSJF, PP, PSJF or RR.
+ *
+ *          schedule -extsort megabytes file.txt
+ *
+ *          Sorts a file that does not need to be in arrival order and
+ *          may not fit in memory using at most the given megabytes,
+ *          then runs the six algorithms on the sorted stream.
+ *
+ *          schedule [-algo algorithm]... [-seed number] file.txt
+ *
+ *          Runs only the given algorithms with the event driven
+ *          dispatcher. Besides the six above, LOTTERY and STRIDE are
+ *          available, the seed makes the lottery draws repeatable.
+ *          NPEDF and PEDF schedule by the deadline in the fifth column.
+ *
+ *          schedule -aging rate [options] file.txt
+ *
+ *          The priority algorithms raise the priority of a waiting
+ *          process one level every rate units of time, so no process
+ *          starves. Any mode accepts it, without -algo the six
+ *          algorithms run with the event driven dispatcher.
+ *
+ *          schedule -export results.csv [options] file.txt
+ *          schedule -exportbin results.bin [options] file.txt
+ *
+ *          Writes the start, finish, wait, response and turnaround
+ *          time of every process and algorithm, as CSV or as binary
+ *          columns. Like -aging it runs the event driven dispatcher.
+ *
+ *          schedule -pipeline [options] file.txt
+ *
+ *          A second thread parses the file while the algorithms run on
+ *          the processes already parsed. The file must be sorted by
+ *          arrival time.
+ *
+ *          schedule -replicas k [-jitter t] [-noise percent] [-resample]
+ *                   [options] file.txt
+ *
+ *          Runs the algorithms on k perturbed copies of the workload
+ *          and prints the mean, standard deviation and 95% confidence
+ *          interval of the averages. The seed makes it repeatable.
+ *          It can not be used with -export or -exportbin.
+ *
+ *          schedule -algo FAIR [-groups groups.txt] file.txt
+ *
+ *          Shares the CPU between groups of processes, given in the
+ *          sixth column, in proportion to the weights of the group
+ *          file, a tree with one "id parent weight" line per group.
+ *
+ *          schedule -import trace.txt [-tick us] [-quantum q]
+ *                   [-convert file.txt] [options]
+ *
+ *          Rebuilds the processes of the output of "perf sched script"
+ *          or of the ftrace sched_switch and sched_wakeup events, "-"
+ *          reads it from the standard input. Every unit of time is
+ *          tick microseconds, by default the smallest that fits the
+ *          trace in an int (1 for the standard input), and the quantum
+ *          is 4 ms unless given. With -convert the processes are written to a
+ *          process file instead of being scheduled.
+ *
+ *          schedule -archive file.sct [-zlib] [options] file.txt
+ *
+ *          Writes the processes, read from a file, an imported trace
+ *          or an external sort, to a compressed process file instead
+ *          of scheduling them. A compressed file is recognised when it
+ *          is given as the file to schedule and its blocks are decoded
+ *          by several threads, -zlib needs a build with HAVE_ZLIB.
+ *
+ *          schedule -stream [options] [file.txt]
+ *
+ *          Reads the file, or the standard input, one process at a time
+ *          while FCFS and Round Robin run, or the algorithms given with
+ *          -algo, and frees every process once it finishes, so the
+ *          memory only depends on the processes active at once. The
+ *          file must be sorted by arrival time.
+ *
  * References:
  *          The material that describe the scheduling algorithms is
  *          covered in my class notes for TC2008
@@ -23,7 +104,12 @@
  * File formats:
  *          The input file should have four numbers per list in ASCII
  *          format. The exeption is teh forst line which only has one
- *          integer number that represents the quantum.
+ *          integer number that represents the quantum. A fifth number
+ *          is optional and gives the deadline of the process relative
+ *          to its arrival, used by NPEDF and PEDF, a negative one means
+ *          none. A sixth number is the group of the process. The cpu burst may
+ *          be a comma separated list of CPU and I/O bursts, like
+ *          3,4,2 for 3 units of CPU, 4 of I/O and 2 more of CPU.
  *
  * Restrictions:
  *          If the input file is not in ASCII format the program exits
@@ -34,6 +120,33 @@
  *
  *          May 24 11:56 2012 - Code refactoring & big fixes
  *
+ *          Oct 19 10:02 2026 - Online mode fed from a pipe
+ *
+ *          Oct 19 11:40 2026 - External sort for large unsorted files
+ *
+ *          Oct 19 14:05 2026 - Lottery and stride scheduling
+ *
+ *          Oct 19 16:30 2026 - Optional deadline column and EDF, the
+ *                              file is now read one line at a time
+ *
+ *          Oct 19 18:10 2026 - CPU and I/O burst sequences
+ *
+ *          Oct 19 19:25 2026 - Aging for the priority algorithms
+ *
+ *          Oct 19 20:40 2026 - Export of the results of every process
+ *
+ *          Oct 19 21:30 2026 - Pipelined parsing
+ *
+ *          Oct 19 22:45 2026 - Monte Carlo replicas
+ *
+ *          Oct 20 09:15 2026 - Hierarchical fair share groups
+ *
+ *          Oct 20 10:40 2026 - Import of perf sched and ftrace traces
+ *
+ *          Oct 20 12:05 2026 - Compressed process files
+ *
+ *          Oct 20 13:20 2026 - Streaming mode with bounded memory
+ *
  * Error handling:
  *          On any unrecoverable error, the program exits
  *
@@ -51,12 +164,102 @@
 #include "FileIO.h"     /* Definition of file access support functions */
 #include "Process.h"    /* Used for handling of processes*/
 #include "Dispatcher.h" /* Implementation of the dispatcher algorithms */
+#include "Export.h"     /* Export of the results of every process */
+#include "FairShare.h"  /* Groups of fair share scheduling */
+#include "Simulator.h"  /* Event driven dispatcher used by the online mode */
+#include "ExternalSort.h" /* Sort of files larger than memory */
+#include "Pipeline.h"   /* Parsing in its own thread */
+#include "MonteCarlo.h" /* Runs over perturbed copies of the workload */
+#include "Import.h"     /* Processes rebuilt from perf and ftrace traces */
+#include "Archive.h"    /* Compressed process files */
 
 /***********************************************************************
  *                       Global constant values                        *
  **********************************************************************/
 #define NUMPARAMS 2 //!< Constant used to define the number of parameters we must receive.
-#define NUMVAL 4    //!< Constant used to define the number of values we shall read from a file.
+#define MAXVAL 5    //!< Constant used to define the number of values with the optional deadline.
+#define PIPELINE_SLOTS 4096 //!< Processes the parser thread may read ahead of the simulator.
+#define IMPORT_SLICE 4000   //!< Default quantum of an imported trace in microseconds.
+
+/***********************************************************************
+ *                          Helper functions                           *
+ **********************************************************************/
+
+/* Declaration of the data structure stream_p with the file read by the streaming and pipelined modes */
+struct stream_p
+{
+    FILE *fp;        /* File with the processes */
+    int lastArrival; /* Arrival of the previous process */
+    int sorted;      /* 0 once a process arrived before the previous one */
+};
+
+/*!
+* Hands the next process of a process file.
+*
+* Receive param fp The file, as a gpointer so it can be used as a ProcessSource
+*
+* return The next process in the order of the file or NULL at its end
+*/
+static Process nextFromFile(gpointer fp)
+{
+    return ReadProcess(fp);
+}
+
+/*!
+* Hands the next process of a process file that must be sorted by arrival.
+*
+* Receive param data The stream_p, as a gpointer so it can be used as a ProcessSource
+*
+* return The next process or NULL at the end of the file or at the first
+*        process out of order
+*/
+static Process nextInOrder(gpointer data)
+{
+    struct stream_p *stream = data;
+    Process process;
+    if (!stream->sorted || (process = ReadProcess(stream->fp)) == NULL)
+        return NULL;
+    if (process->process_arrival < stream->lastArrival)
+    {
+        ErrorMsg("main", "file is not sorted by arrival time, the rest is ignored");
+        freeNode(process);
+        stream->sorted = 0;
+        return NULL;
+    }
+    stream->lastArrival = process->process_arrival;
+    return process;
+}
+
+/*!
+* Writes every process of a source to a compressed process file.
+*
+* Receive param filename Name of the file
+* Receive param quantum Quantum stored in the file
+* Receive param compress 1 to compress the blocks with zlib
+* Receive param source Hands the processes
+* Receive param data Argument of the source
+*
+* return EXIT_SUCCESS or EXIT_FAILURE if the file can not be created or written
+*
+* A file that could not be written completely is removed.
+*/
+static int writeArchive(const char *filename, int quantum, int compress, ProcessSource source, gpointer data)
+{
+    ArchiveWriter writer = CreateArchiveWriter(filename, quantum, compress);
+    Process process;
+    int status;
+    if (writer == NULL)
+        return (EXIT_FAILURE);
+    while ((process = source(data)) != NULL)
+    {
+        ArchiveWrite(writer, process);
+        freeNode(process);
+    }
+    status = DestroyArchiveWriter(writer);
+    if (status != EXIT_SUCCESS)
+        remove(filename);
+    return (status);
+}
 
 /***********************************************************************
  *                          Main entry point                           *
@@ -67,11 +270,347 @@ int main(int argc, const char *argv[])
     FILE *fp;                    /* Pointer to the file */
     int quantum = 0;             /* Quantum value for round robin */
     GList *processList_p = NULL; /* Pointer to the process list */
-    int parameters[NUMVAL];      /* Process parameters in the line */
-    int i;                       /* Number of parameters in the process */
+    int parameters[MAXVAL];      /* Process parameters in the line */
+    Process process;             /* Process read from the line */
+    int i;                       /* Index of the argument */
+    const char *filename = NULL; /* Name of the process file */
+    int online = -1;             /* Algorithm of the online mode, -1 if off */
+    int report = 0;              /* Interval between online metric reports */
+    long extsort = 0;            /* Memory budget of the external sort in megabytes */
+    ExternalSort sorter;         /* Merges the runs of the external sort */
+    int algorithms[NUM_ALGORITHMS]; /* Algorithms given with -algo */
+    int count = 0;               /* Number of algorithms given with -algo */
+    int algorithm;               /* Algorithm read from the arguments */
+    guint32 seed = 1;            /* Seed of the lottery draws */
+    int aging = 0;               /* Aging rate of the priority algorithms */
+    const char *exportname = NULL; /* File where the results of every process go */
+    int format = EXPORT_CSV;     /* Format of the export file */
+    Exporter exporter = NULL;    /* Writes the results of every process */
+    int pipeline = 0;            /* 1 to parse the file in its own thread */
+    Pipeline parser;             /* Hands the parsed processes to the simulator */
+    int replicas = 0;            /* Number of Monte Carlo replicas, 0 for none */
+    struct perturbation_p perturbation = {0, 0, 0}; /* How each replica changes the workload */
+    GroupTable groups = NULL;    /* Groups of fair share scheduling */
+    GList *cursor;               /* Next process handed to the simulator */
+    const char *importname = NULL; /* Trace of the Linux scheduler to import */
+    const char *convertname = NULL; /* Process file written from the imported trace */
+    int tick = 0;                /* Microseconds per unit of time of the imported trace, 0 to choose it */
+    Importer importer;           /* Rebuilds the processes of the trace */
+    FILE *out;                   /* Process file written from the trace */
+    const char *archivename = NULL; /* Compressed process file to write */
+    int compress = 0;            /* 1 to compress the blocks with zlib */
+    int archived = 0;            /* 1 if the file given is a compressed process file */
+    Archive archive;             /* Decodes the compressed process file */
+    int status = EXIT_SUCCESS;   /* Exit status of the conversions */
+    int streaming = 0;           /* 1 to read the file as the algorithms run, without a list */
+    struct stream_p stream;      /* File read by the streaming and pipelined modes */
+
+    /* Options go before the file name */
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-online") == 0 && i + 1 < argc)
+        {
+            online = ParseAlgorithm(argv[++i]);
+            if (online < 0)
+            {
+                ErrorMsg("main", "Unknown algorithm");
+                return (EXIT_FAILURE);
+            }
+        }
+        else if (strcmp(argv[i], "-report") == 0 && i + 1 < argc)
+            report = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-extsort") == 0 && i + 1 < argc)
+            extsort = atol(argv[++i]);
+        else if (strcmp(argv[i], "-algo") == 0 && i + 1 < argc)
+        {
+            algorithm = ParseAlgorithm(argv[++i]);
+            if (algorithm < 0)
+            {
+                ErrorMsg("main", "Unknown algorithm");
+                return (EXIT_FAILURE);
+            }
+            if (count < NUM_ALGORITHMS)
+                algorithms[count++] = algorithm;
+        }
+        else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+            seed = (guint32)atol(argv[++i]);
+        else if (strcmp(argv[i], "-aging") == 0 && i + 1 < argc)
+            aging = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-export") == 0 && i + 1 < argc)
+        {
+            exportname = argv[++i];
+            format = EXPORT_CSV;
+        }
+        else if (strcmp(argv[i], "-pipeline") == 0)
+            pipeline = 1;
+        else if (strcmp(argv[i], "-stream") == 0)
+            streaming = 1;
+        else if (strcmp(argv[i], "-replicas") == 0 && i + 1 < argc)
+            replicas = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-jitter") == 0 && i + 1 < argc)
+            perturbation.jitter = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-noise") == 0 && i + 1 < argc)
+            perturbation.noise = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-resample") == 0)
+            perturbation.resample = 1;
+        else if (strcmp(argv[i], "-groups") == 0 && i + 1 < argc)
+        {
+            fp = fopen(argv[++i], "r");
+            if (!fp)
+            {
+                ErrorMsg("main", "group file does not exist or is corrupted");
+                return (EXIT_FAILURE);
+            }
+            groups = ReadGroupTable(fp);
+            fclose(fp);
+        }
+        else if (strcmp(argv[i], "-import") == 0 && i + 1 < argc)
+            importname = argv[++i];
+        else if (strcmp(argv[i], "-convert") == 0 && i + 1 < argc)
+            convertname = argv[++i];
+        else if (strcmp(argv[i], "-tick") == 0 && i + 1 < argc)
+            tick = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-quantum") == 0 && i + 1 < argc)
+            quantum = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-archive") == 0 && i + 1 < argc)
+            archivename = argv[++i];
+        else if (strcmp(argv[i], "-zlib") == 0)
+            compress = 1;
+        else if (strcmp(argv[i], "-exportbin") == 0 && i + 1 < argc)
+        {
+            exportname = argv[++i];
+            format = EXPORT_BINARY;
+        }
+        else
+            filename = argv[i];
+    }
+
+    /* The replicas only keep the averages, so there is nothing to export */
+    if (exportname != NULL && replicas > 0)
+    {
+        ErrorMsg("main", "-export can not be used with -replicas");
+        return (EXIT_FAILURE);
+    }
+
+    if (exportname != NULL && (exporter = CreateExporter(exportname, format)) == NULL)
+        return (EXIT_FAILURE);
+
+    if (online >= 0)
+    {
+        /* Without a file the processes come from the standard input */
+        fp = (filename != NULL) ? fopen(filename, "r") : stdin;
+        if (!fp)
+        {
+            ErrorMsg("main", "filename does not exist or is corrupted");
+            return (EXIT_FAILURE);
+        }
+        OnlineSchedule(fp, stdout, online, report, seed, aging, exporter, groups);
+        if (exporter != NULL)
+            DestroyExporter(exporter);
+        return (EXIT_SUCCESS);
+    }
+
+    /* A compressed process file is recognised by its first bytes */
+    if (filename != NULL && (fp = fopen(filename, "rb")) != NULL)
+    {
+        archived = IsArchive(fp);
+        fclose(fp);
+    }
+
+    /* Without -algo the streaming mode runs the two algorithms that never look ahead */
+    if (count == 0 && streaming && !archived)
+    {
+        algorithms[count++] = FCFS;
+        algorithms[count++] = ROUNDROBIN;
+    }
+
+    /* Without -algo the event driven modes run the six algorithms */
+    if (count == 0 && (extsort > 0 || pipeline || replicas > 0 || aging > 0 || exporter != NULL || importname != NULL ||
+                       archived))
+        for (count = 0; count <= ROUNDROBIN; count++)
+            algorithms[count] = count;
+
+    if (importname != NULL)
+    {
+        /* A trace of "-" is read from the standard input, like a pipe from perf */
+        fp = (strcmp(importname, "-") == 0) ? stdin : fopen(importname, "r");
+        if (!fp)
+        {
+            ErrorMsg("main", "trace does not exist or is corrupted");
+            return (EXIT_FAILURE);
+        }
+        importer = CreateImporter(fp, tick);
+        tick = ImporterTick(importer);
+        if (quantum <= 0)
+            quantum = (IMPORT_SLICE / tick > 0) ? IMPORT_SLICE / tick : 1;
+        if (archivename != NULL)
+        {
+            status = writeArchive(archivename, quantum, compress, ImporterNext, importer);
+        }
+        else if (convertname != NULL)
+        {
+            out = fopen(convertname, "w");
+            if (!out)
+            {
+                ErrorMsg("main", "process file could not be created");
+                return (EXIT_FAILURE);
+            }
+            fprintf(out, "%d\n", quantum);
+            while ((process = ImporterNext(importer)) != NULL)
+            {
+                WriteProcess(out, process);
+                freeNode(process);
+            }
+            fclose(out);
+        }
+        else
+        {
+            SimulateAll(ImporterNext, importer, algorithms, count, quantum, seed, aging, exporter, groups);
+        }
+        DestroyImporter(importer);
+        if (fp != stdin)
+            fclose(fp);
+        if (exporter != NULL)
+            DestroyExporter(exporter);
+        if (status != EXIT_SUCCESS)
+            return (status);
+        printf("Program terminated correctly\n");
+        return (EXIT_SUCCESS);
+    }
+
+    if (archived)
+    {
+        fp = fopen(filename, "rb");
+        /* The blocks are decoded by other threads while the algorithms run */
+        if ((archive = OpenArchive(fp)) == NULL)
+            return (EXIT_FAILURE);
+        quantum = ArchiveQuantum(archive);
+        if (archivename != NULL)
+            status = writeArchive(archivename, quantum, compress, ArchiveNext, archive);
+        else
+            SimulateAll(ArchiveNext, archive, algorithms, count, quantum, seed, aging, exporter, groups);
+        /* A damaged archive only gives the processes before the damage */
+        if (ArchiveFailed(archive))
+        {
+            if (archivename != NULL && status == EXIT_SUCCESS)
+                remove(archivename);
+            status = EXIT_FAILURE;
+        }
+        DestroyArchive(archive);
+        fclose(fp);
+        if (exporter != NULL)
+            DestroyExporter(exporter);
+        if (status != EXIT_SUCCESS)
+            return (status);
+        printf("Program terminated correctly\n");
+        return (EXIT_SUCCESS);
+    }
+
+    if (extsort > 0 && filename != NULL)
+    {
+        fp = fopen(filename, "r");
+        if (!fp)
+        {
+            ErrorMsg("main", "filename does not exist or is corrupted");
+            return (EXIT_FAILURE);
+        }
+        /* The first number in the file is the quantum */
+        if (GetLine(fp, parameters, MAXVAL) > 0)
+            quantum = parameters[0];
+        sorter = CreateExternalSort(fp, extsort * 1024 * 1024);
+        fclose(fp);
+        if (sorter == NULL)
+            return (EXIT_FAILURE);
+        if (archivename != NULL)
+            status = writeArchive(archivename, quantum, compress, ExternalSortNext, sorter);
+        else
+            SimulateAll(ExternalSortNext, sorter, algorithms, count, quantum, seed, aging, exporter, groups);
+        DestroyExternalSort(sorter);
+        if (exporter != NULL)
+            DestroyExporter(exporter);
+        if (status != EXIT_SUCCESS)
+            return (status);
+        printf("Program terminated correctly\n");
+        return (EXIT_SUCCESS);
+    }
+
+    if (archivename != NULL && filename != NULL)
+    {
+        fp = fopen(filename, "r");
+        if (!fp)
+        {
+            ErrorMsg("main", "filename does not exist or is corrupted");
+            return (EXIT_FAILURE);
+        }
+        /* The first number in the file is the quantum */
+        if (GetLine(fp, parameters, MAXVAL) > 0)
+            quantum = parameters[0];
+        status = writeArchive(archivename, quantum, compress, nextFromFile, fp);
+        fclose(fp);
+        if (exporter != NULL)
+            DestroyExporter(exporter);
+        if (status != EXIT_SUCCESS)
+            return (status);
+        printf("Program terminated correctly\n");
+        return (EXIT_SUCCESS);
+    }
+
+    if (streaming && !archived && extsort == 0)
+    {
+        /* Without a file the processes come from the standard input */
+        fp = (filename != NULL) ? fopen(filename, "r") : stdin;
+        if (!fp)
+        {
+            ErrorMsg("main", "filename does not exist or is corrupted");
+            return (EXIT_FAILURE);
+        }
+        /* The first number in the file is the quantum */
+        if (GetLine(fp, parameters, MAXVAL) > 0)
+            quantum = parameters[0];
+        /* Each process is freed as soon as it finishes, no list is kept */
+        stream.fp = fp;
+        stream.lastArrival = 0;
+        stream.sorted = 1;
+        SimulateAll(nextInOrder, &stream, algorithms, count, quantum, seed, aging, exporter, groups);
+        if (fp != stdin)
+            fclose(fp);
+        if (exporter != NULL)
+            DestroyExporter(exporter);
+        if (!stream.sorted)
+            return (EXIT_FAILURE);
+        printf("Program terminated correctly\n");
+        return (EXIT_SUCCESS);
+    }
+
+    if (pipeline && filename != NULL)
+    {
+        fp = fopen(filename, "r");
+        if (!fp)
+        {
+            ErrorMsg("main", "filename does not exist or is corrupted");
+            return (EXIT_FAILURE);
+        }
+        /* The first number in the file is the quantum */
+        if (GetLine(fp, parameters, MAXVAL) > 0)
+            quantum = parameters[0];
+        /* The file is parsed by another thread while the algorithms run */
+        stream.fp = fp;
+        stream.lastArrival = 0;
+        stream.sorted = 1;
+        parser = CreatePipeline(nextInOrder, &stream, PIPELINE_SLOTS);
+        SimulateAll(PipelineNext, parser, algorithms, count, quantum, seed, aging, exporter, groups);
+        DestroyPipeline(parser);
+        fclose(fp);
+        if (exporter != NULL)
+            DestroyExporter(exporter);
+        if (!stream.sorted)
+            return (EXIT_FAILURE);
+        printf("Program terminated correctly\n");
+        return (EXIT_SUCCESS);
+    }
 
     /* Check if the number of parameters is correct */
-    if (argc < NUMPARAMS)
+    if (argc < NUMPARAMS || filename == NULL)
     {
         printf("Need a file with the process information\n");
         printf("Abnormal termination\n");
@@ -80,7 +619,7 @@ int main(int argc, const char *argv[])
     else
     {
         /* Open the file and check that it exists */
-        fp = fopen(argv[1], "r"); /* Open file for read operation */
+        fp = fopen(filename, "r"); /* Open file for read operation */
         if (!fp)
         { /* There is an error */
             ErrorMsg("main", "filename does not exist or is corrupted");
@@ -100,25 +639,12 @@ int main(int argc, const char *argv[])
                  * Read the process information until the end of file
                  * is reached.
                  */
-                while (!feof(fp))
+                while ((process = ReadProcess(fp)) != NULL)
                 {
-                    /* For every four parameters create a new process */
-                    for (i = 0; ((i < NUMVAL) && (!feof(fp))); i++)
-                    {
-                        parameters[i] = GetInt(fp);
-                    }
-
-                    /* Do we have four parameters? */
-                    if (i == NUMVAL)
-                    {
-                        processList_p = CreateProcess(processList_p,
-                                                      parameters[0],
-                                                      parameters[1],
-                                                      parameters[2],
-                                                      parameters[3],
-                                                      1);
-                    }
+                    /* Prepending is O(1), the list is reversed once at the end */
+                    processList_p = g_list_prepend(processList_p, process);
                 }
+                processList_p = g_list_reverse(processList_p);
             }
         }
 
@@ -130,23 +656,45 @@ int main(int argc, const char *argv[])
         PrintProcessList(processList_p);
 #endif
 
-        /*
-         * Apply all the scheduling algorithms and print the results
-         */
-        FirstCome(processList_p);
+        /* The original dispatchers merge the CPU bursts, so lists of bursts go to the event driven one */
+        for (cursor = processList_p; count == 0 && cursor != NULL; cursor = cursor->next)
+            if (((Process)cursor->data)->process_nbursts > 1)
+                for (count = 0; count <= ROUNDROBIN; count++)
+                    algorithms[count] = count;
+
+        if (replicas > 0)
+        {
+            /* The algorithms run on perturbed copies of the workload */
+            MonteCarlo(processList_p, algorithms, count, quantum, seed, aging, groups, replicas, &perturbation);
+        }
+        else if (count > 0)
+        {
+            /* Only the algorithms given are run, with the event driven dispatcher */
+            cursor = processList_p;
+            SimulateAll(NextFromList, &cursor, algorithms, count, quantum, seed, aging, exporter, groups);
+        }
+        else
+        {
+            /*
+             * Apply all the scheduling algorithms and print the results
+             */
+            FirstCome(processList_p);
 
-        NonPreemptive(processList_p, PRIORITY);
+            NonPreemptive(processList_p, PRIORITY);
 
-        NonPreemptive(processList_p, CPUBURST);
+            NonPreemptive(processList_p, CPUBURST);
 
-        Preemptive(processList_p, PRIORITY);
+            Preemptive(processList_p, PRIORITY);
 
-        Preemptive(processList_p, CPUBURST);
+            Preemptive(processList_p, CPUBURST);
 
-        RoundRobin(processList_p, quantum);
+            RoundRobin(processList_p, quantum);
+        }
 
         /* Deallocate the memory assigned to the list */
         DestroyList(processList_p);
+        if (exporter != NULL)
+            DestroyExporter(exporter);
 
         printf("Program terminated correctly\n");
         return (EXIT_SUCCESS);
@@ -0,0 +1,1179 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Simulator.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Event driven implementation of the scheduling algorithms
+ *          that receives the processes one at a time.
+ *
+ * References:
+ *          Same algorithms as Dispatcher.c, the ready list is replaced
+ *          by a heap and time jumps from one event to the next one.
+ *
+ * Error handling:
+ *          None
+ *
+ * Notes:
+ *          The dispatchers in Dispatcher.c need the whole list before
+ *          they start and walk it once per time unit. Here every process
+ *          is handed to the simulator when it arrives and is freed as
+ *          soon as it finishes, so memory only holds the active processes
+ *          and every event costs O(log n).
+ *
+ *          Decisions are taken as soon as an event or an arrival happens.
+ *          A process dispatched at the current time has not used the CPU
+ *          yet, so a later arrival at that same time that goes before it
+ *          takes its place, this keeps the results equal to the ones in
+ *          Dispatcher.c.
+ *
+ *          Lottery and stride scheduling give every process a number of
+ *          tickets that decreases with its priority value, so priority 0
+ *          gets the biggest share of the CPU. Both run for a quantum like
+ *          Round Robin. Lottery draws from a Fenwick tree (Lottery.c) and
+ *          stride keeps the heap ordered by pass value.
+ *
+ *          Earliest Deadline First keeps the heap ordered by absolute
+ *          deadline. The lateness of every process with a deadline goes
+ *          to a histogram so its percentiles can be reported without
+ *          keeping the processes.
+ *
+ *          A process may alternate CPU and I/O bursts. While it does I/O
+ *          it waits in a hierarchical timing wheel (TimerWheel.c) and the
+ *          wake ups are events like the end of a CPU burst. The wait time
+ *          does not count the time spent in I/O.
+ *
+ *          The totals of a group include its subgroups. Every group
+ *          counts its processes ready or running, so moving the clock
+ *          only charges the groups that have some and the share of a
+ *          group is measured while other groups compete with it.
+ *
+ */
+#include <stdio.h>      /* Used for the fprintf function */
+#include <stdlib.h>     /* Used for memory manipulation */
+#include <string.h>     /* Used for strcmp */
+#include <glib.h>       /* Used for gpointer and GCompareFunc */
+#include "FileIO.h"     /* Used for GetLine */
+#include "Process.h"    /* Used for the data structures and enums */
+#include "Heap.h"       /* Used for the ready queue */
+#include "Lottery.h"    /* Used for the ready queue of lottery scheduling */
+#include "Histogram.h"  /* Used for the lateness percentiles */
+#include "TimerWheel.h" /* Used for the processes doing I/O */
+#include "Export.h"     /* Used for the results of every process */
+#include "FairShare.h"  /* Used for the ready queue of fair share scheduling */
+#include "Simulator.h"  /* Function header */
+
+#define MAXVAL 5             //!< Values with the optional deadline.
+#define MAX_TICKETS 1000     //!< Tickets of a process with priority 0.
+#define STRIDE_ONE (1 << 20) //!< Pass advanced by a process with one ticket.
+
+/* Declaration of the data structure group_stats_p with the totals of one group */
+struct group_stats_p
+{
+    int id;                  /* Id of the group */
+    struct group_stats_p *parent; /* Group above, NULL for a group under the root */
+    int runnable;            /* Processes of the group and its subgroups ready or running */
+    long long contended;     /* Time it had runnable processes while other groups did too */
+    long long share;         /* Cpu time it received during the contended time */
+    long long finished;      /* Processes finished */
+    long long sumWait;       /* Accumulated wait time */
+    long long sumResponse;   /* Accumulated response time */
+    long long sumTurnaround; /* Accumulated turnaround time */
+};
+
+/* Declaration of the data structure simulator_p that holds the state of one algorithm */
+struct simulator_p
+{
+    int algorithm;          /* Value of algorithm_type being simulated */
+    int quantum;            /* Time slice, 0 if the algorithm has none */
+    int preemptive;         /* 1 if an arrival may take the CPU away */
+    GCompareFunc compare;   /* Order of the ready queue */
+    Heap ready;             /* Processes waiting for the CPU */
+    Lottery lottery;        /* Processes waiting for the CPU in lottery scheduling */
+    FairShare fair;         /* Processes waiting for the CPU in fair share scheduling */
+    long long globalPass;   /* Pass of the last process dispatched by stride */
+    long long lastPass;     /* Value of globalPass before the dispatches at clock */
+    int aging;              /* Time a process waits to gain one priority level, 0 for none */
+    Process running;        /* Process using the CPU or NULL */
+    int clock;              /* Current time of execution */
+    int sliceStart;         /* Time the running process was dispatched */
+    long long sequence;     /* Counter used to keep the FIFO order */
+    int active;             /* Processes arrived and not finished */
+    int maxActive;          /* Highest value active has reached */
+    long long finished;     /* Processes finished */
+    long long sumWait;      /* Accumulated wait time */
+    long long sumResponse;  /* Accumulated response time */
+    long long sumTurnaround; /* Accumulated turnaround time */
+    double sumSlowdown;     /* Accumulated turnaround divided by burst */
+    double sumSlowdown2;    /* Accumulated square of the slowdown */
+    int firstArrival;       /* Arrival of the first process */
+    int lastFinish;         /* Time the last process finished */
+    long long missed;       /* Processes that finished after their deadline */
+    Histogram lateness;     /* Finish time minus deadline of the processes with one */
+    TimerWheel wheel;       /* Processes waiting for their I/O to end */
+    GHashTable *groups;     /* Totals of every group by id */
+    GHashTable *busy;       /* Groups with processes ready or running */
+    int runnable;           /* Processes ready or running */
+    int grouped;            /* 1 once a process of a group other than 0 finished */
+    FILE *log;              /* Where the decisions are written, can be NULL */
+    Exporter exporter;      /* Where the results of every process go, can be NULL */
+    int report;             /* Interval between metric reports, 0 for none */
+    int nextReport;         /* Time of the next metric report */
+};
+
+/*!
+* Compares processes by the order they entered the ready queue.
+*
+* Receive param a Pointer to the first process
+* Receive param b Pointer to the second process
+*
+* return a negative value if a entered first
+*/
+static gint compareSequence(gconstpointer a, gconstpointer b)
+{
+    const struct process_p *aa = a;
+    const struct process_p *bb = b;
+    if (aa->process_sequence != bb->process_sequence)
+        return (aa->process_sequence < bb->process_sequence) ? -1 : 1;
+    return 0;
+}
+
+/*!
+* Compares processes by priority, ties are broken by ID.
+*
+* Receive param a Pointer to the first process
+* Receive param b Pointer to the second process
+*
+* return a negative value if a goes first
+*/
+static gint comparePriority(gconstpointer a, gconstpointer b)
+{
+    const struct process_p *aa = a;
+    const struct process_p *bb = b;
+    int compare = aa->process_priority - bb->process_priority;
+    if (compare == 0)
+        compare = aa->process_id - bb->process_id;
+    return compare;
+}
+
+/*!
+* Compares processes by the cpu burst they have left, ties are broken by ID.
+*
+* Receive param a Pointer to the first process
+* Receive param b Pointer to the second process
+*
+* return a negative value if a goes first
+*/
+static gint compareRemaining(gconstpointer a, gconstpointer b)
+{
+    const struct process_p *aa = a;
+    const struct process_p *bb = b;
+    int compare = aa->process_remainingcycles - bb->process_remainingcycles;
+    if (compare == 0)
+        compare = aa->process_id - bb->process_id;
+    return compare;
+}
+
+/*!
+* Compares processes by pass value, ties are broken by ID.
+*
+* Receive param a Pointer to the first process
+* Receive param b Pointer to the second process
+*
+* return a negative value if a goes first
+*/
+static gint comparePass(gconstpointer a, gconstpointer b)
+{
+    const struct process_p *aa = a;
+    const struct process_p *bb = b;
+    if (aa->process_pass != bb->process_pass)
+        return (aa->process_pass < bb->process_pass) ? -1 : 1;
+    return aa->process_id - bb->process_id;
+}
+
+/*!
+* Compares processes by deadline, ties are broken by ID.
+*
+* Receive param a Pointer to the first process
+* Receive param b Pointer to the second process
+*
+* return a negative value if a goes first, processes without deadline go last
+*/
+static gint compareDeadline(gconstpointer a, gconstpointer b)
+{
+    const struct process_p *aa = a;
+    const struct process_p *bb = b;
+    if (aa->process_deadline != bb->process_deadline)
+    {
+        if (aa->process_deadline == NO_DEADLINE)
+            return 1;
+        if (bb->process_deadline == NO_DEADLINE)
+            return -1;
+        return (aa->process_deadline < bb->process_deadline) ? -1 : 1;
+    }
+    return aa->process_id - bb->process_id;
+}
+
+/*!
+* Returns the tickets of a process for lottery and stride scheduling.
+*
+* Receive param process The process
+*
+* return MAX_TICKETS divided by the priority plus one, at least 1
+*/
+static int ticketsOf(Process process)
+{
+    int priority = (process->process_priority > 0) ? process->process_priority : 0;
+    int tickets = MAX_TICKETS / (priority + 1);
+    return (tickets > 0) ? tickets : 1;
+}
+
+/*!
+* Translates the name of an algorithm to its algorithm_type value.
+*
+* Receive param name Short name: FCFS, NPP, NPSJF, PP, PSJF, RR, LOTTERY, STRIDE, NPEDF, PEDF or FAIR
+*
+* return The algorithm_type value or -1 if the name is unknown
+*/
+int ParseAlgorithm(const char *name)
+{
+    if (strcmp(name, "FCFS") == 0)
+        return FCFS;
+    if (strcmp(name, "NPP") == 0)
+        return NP_PRIORITY;
+    if (strcmp(name, "NPSJF") == 0)
+        return NP_SJF;
+    if (strcmp(name, "PP") == 0)
+        return P_PRIORITY;
+    if (strcmp(name, "PSJF") == 0)
+        return P_SJF;
+    if (strcmp(name, "RR") == 0)
+        return ROUNDROBIN;
+    if (strcmp(name, "LOTTERY") == 0)
+        return LOTTERY;
+    if (strcmp(name, "STRIDE") == 0)
+        return STRIDE;
+    if (strcmp(name, "NPEDF") == 0)
+        return NP_EDF;
+    if (strcmp(name, "PEDF") == 0)
+        return P_EDF;
+    if (strcmp(name, "FAIR") == 0)
+        return FAIR_SHARE;
+    return -1;
+}
+
+/*!
+* Returns the text used to present an algorithm.
+*
+* Receive param algorithm Value of algorithm_type
+*
+* return The same names used by Dispatcher.c
+*/
+char *AlgorithmName(int algorithm)
+{
+    if (algorithm == FCFS)
+        return "FCFS";
+    if (algorithm == NP_PRIORITY)
+        return "NonPreemptive Priority";
+    if (algorithm == NP_SJF)
+        return "NonPreemptive SJF";
+    if (algorithm == P_PRIORITY)
+        return "Preemptive Priority";
+    if (algorithm == P_SJF)
+        return "Preemptive SJF";
+    if (algorithm == LOTTERY)
+        return "Lottery";
+    if (algorithm == STRIDE)
+        return "Stride";
+    if (algorithm == NP_EDF)
+        return "NonPreemptive EDF";
+    if (algorithm == P_EDF)
+        return "Preemptive EDF";
+    if (algorithm == FAIR_SHARE)
+        return "Fair Share";
+    return "Round Robin";
+}
+
+/*!
+* Creates a simulator for one algorithm.
+*
+* Receive param algorithm Value of algorithm_type
+* Receive param quantum Time slice, only used by Round Robin
+*
+* return Pointer to the new simulator
+*/
+Simulator CreateSimulator(int algorithm, int quantum)
+{
+    Simulator sim = (Simulator)calloc(1, sizeof(struct simulator_p));
+    sim->algorithm = algorithm;
+    sim->quantum = (algorithm == ROUNDROBIN || algorithm == LOTTERY || algorithm == STRIDE ||
+                    algorithm == FAIR_SHARE) ? quantum : 0;
+    sim->preemptive = (algorithm == P_PRIORITY || algorithm == P_SJF || algorithm == P_EDF);
+    /* The order of the ready queue depends on the algorithm */
+    if (algorithm == NP_PRIORITY || algorithm == P_PRIORITY)
+        sim->compare = comparePriority;
+    else if (algorithm == NP_SJF || algorithm == P_SJF)
+        sim->compare = compareRemaining;
+    else if (algorithm == STRIDE)
+        sim->compare = comparePass;
+    else if (algorithm == NP_EDF || algorithm == P_EDF)
+        sim->compare = compareDeadline;
+    else
+        sim->compare = compareSequence;
+    sim->ready = CreateHeap(sim->compare);
+    sim->lottery = (algorithm == LOTTERY) ? CreateLottery(1) : NULL;
+    sim->fair = (algorithm == FAIR_SHARE) ? CreateFairShare(NULL) : NULL;
+    sim->firstArrival = -1;
+    sim->lateness = CreateHistogram();
+    sim->groups = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, free);
+    sim->busy = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+    sim->wheel = CreateTimerWheel(0);
+    sim->running = NULL;
+    return sim;
+}
+
+/*!
+* Sets the seed of the random numbers used by lottery scheduling.
+*
+* Receive param sim The simulator
+* Receive param seed Seed, the same seed repeats the same draws
+*/
+void SimulatorSetSeed(Simulator sim, guint32 seed)
+{
+    if (sim->lottery != NULL)
+        LotterySeed(sim->lottery, seed);
+}
+
+/*!
+* Returns the totals of a group, creating them under the root if needed.
+*
+* Receive param sim The simulator
+* Receive param id Id of the group
+*
+* return Pointer to the totals
+*/
+static struct group_stats_p *getGroup(Simulator sim, int id)
+{
+    struct group_stats_p *stats = g_hash_table_lookup(sim->groups, GINT_TO_POINTER(id));
+    if (stats == NULL)
+    {
+        stats = (struct group_stats_p *)calloc(1, sizeof(struct group_stats_p));
+        stats->id = id;
+        g_hash_table_insert(sim->groups, GINT_TO_POINTER(id), stats);
+    }
+    return stats;
+}
+
+/*!
+* Sets the tree of groups used by fair share scheduling.
+*
+* Receive param sim The simulator, before any process arrives
+* Receive param table The groups, NULL if every group hangs from the root
+*
+* Every algorithm adds the totals of a group to the groups above it.
+  Group 0 only holds the processes without a group, so the groups
+  under the root have no parent. A group that would be its own
+  ancestor stays under the root, the fair share queue reports it.
+*/
+void SimulatorSetGroups(Simulator sim, GroupTable table)
+{
+    struct group_stats_p *stats, *parent, *above;
+    int i, id;
+    if (table == NULL)
+        return;
+    for (i = 0; i < GroupTableSize(table); i++)
+    {
+        parent = getGroup(sim, GroupTableEntry(table, i, &id));
+        stats = getGroup(sim, id);
+        for (above = parent; above != NULL && above != stats; above = above->parent)
+            ;
+        stats->parent = (above == stats || parent->id == 0) ? NULL : parent;
+    }
+    if (sim->fair == NULL)
+        return;
+    DestroyFairShare(sim->fair, NULL);
+    sim->fair = CreateFairShare(table);
+}
+
+/*!
+* Makes the priority algorithms age the processes that wait.
+*
+* Receive param sim The simulator, before any process arrives
+* Receive param rate Time a process waits to gain one priority level, 0 for none
+*
+* The effective priority of a process that entered the ready queue at
+  time e is priority - (clock - e) / rate. Aging every process on every
+  tick would be O(n), but the order of two waiting processes never
+  changes as the clock moves, so the queue is a heap keyed on
+  priority * rate + e, computed once when the process enters it. Only
+  the time spent waiting counts, so the key of the running process grows
+  with the time it has run since it was dispatched. The preemptive
+  variant compares that key with the head of the queue when a process
+  arrives, and a preempted process goes back with it, keeping the credit
+  it earned while it waited.
+*/
+void SimulatorSetAging(Simulator sim, int rate)
+{
+    if (rate <= 0 || (sim->algorithm != NP_PRIORITY && sim->algorithm != P_PRIORITY))
+        return;
+    sim->aging = rate;
+    sim->compare = comparePass;
+    DestroyHeap(sim->ready, NULL);
+    sim->ready = CreateHeap(sim->compare);
+}
+
+/*!
+* Returns the aged priority key of a process that waits from now on.
+*
+* Receive param sim The simulator
+* Receive param process The process
+*
+* return Priority times the aging rate plus the current time
+*/
+static long long agedKey(Simulator sim, Process process)
+{
+    return (long long)process->process_priority * sim->aging + sim->clock;
+}
+
+/*!
+* Returns the aged priority key of the running process.
+*
+* Receive param sim The simulator
+*
+* return Its key in the queue plus the time it has run since it was dispatched
+*/
+static long long runningKey(Simulator sim)
+{
+    return sim->running->process_pass + sim->clock - sim->sliceStart;
+}
+
+/*!
+* Sets where the decisions and the periodic metrics are written.
+*
+* Receive param sim The simulator
+* Receive param log File for the decisions, NULL to disable them
+* Receive param report Time between metric reports, 0 to disable them
+*/
+void SimulatorSetLog(Simulator sim, FILE *log, int report)
+{
+    sim->log = log;
+    sim->report = report;
+    sim->nextReport = report;
+}
+
+/*!
+* Sets where the results of every process are exported.
+*
+* Receive param sim The simulator
+* Receive param exporter The exporter, NULL to disable the export
+*
+* Several simulators may share the same exporter.
+*/
+void SimulatorSetExport(Simulator sim, Exporter exporter)
+{
+    sim->exporter = exporter;
+}
+
+/*!
+* Writes a decision to the log.
+*
+* Receive param sim The simulator
+* Receive param event Text describing the decision
+* Receive param process The process affected
+*/
+static void logEvent(Simulator sim, char *event, Process process)
+{
+    if (sim->log != NULL)
+        fprintf(sim->log, "%d %s %d\n", sim->clock, event, process->process_id);
+}
+
+/*!
+* Writes the running averages to the log if a report is due.
+*
+* Receive param sim The simulator
+*/
+static void reportMetrics(Simulator sim)
+{
+    double n;
+    if (sim->log == NULL || sim->report <= 0 || sim->clock < sim->nextReport)
+        return;
+    n = sim->finished > 0 ? (double)sim->finished : 1.0;
+    fprintf(sim->log, "%d metrics finished %lld active %d wait %f response %f turnaround %f\n",
+            sim->clock, sim->finished, sim->active, sim->sumWait / n,
+            sim->sumResponse / n, sim->sumTurnaround / n);
+    /* The next report is the first multiple of the interval after the clock */
+    sim->nextReport = (sim->clock / sim->report + 1) * sim->report;
+}
+
+/*!
+* Returns the pass a new process of stride scheduling starts from.
+*
+* Receive param sim The simulator
+*
+* return The pass of the last process dispatched before the current time
+*
+* A process dispatched at the current time may still give the CPU to a
+  process that arrives at that time, so it does not move the base.
+*/
+static long long strideBase(Simulator sim)
+{
+    if (sim->running != NULL && sim->sliceStart == sim->clock)
+        return sim->lastPass;
+    return sim->globalPass;
+}
+
+/*!
+* Puts a process in the ready queue.
+*
+* Receive param sim The simulator
+* Receive param process The process that becomes ready
+*
+* In stride scheduling a new process starts one stride after the last
+  pass dispatched. A process that comes back from I/O starts no earlier
+  than that either, so it does not gain credit while it sleeps, like
+  FairShareAdd does with the virtual runtime. The rest were charged when
+  they left the CPU. With aging the pass holds the aged priority key
+  instead.
+*/
+static void enqueue(Simulator sim, Process process)
+{
+    long long pass; /* Lowest pass a process of stride scheduling starts with */
+    process->process_sequence = sim->sequence++;
+    if (sim->algorithm == LOTTERY)
+    {
+        LotteryAdd(sim->lottery, process, ticketsOf(process));
+        return;
+    }
+    if (sim->algorithm == FAIR_SHARE)
+    {
+        FairShareAdd(sim->fair, process);
+        return;
+    }
+    if (sim->algorithm == STRIDE && process != sim->running)
+    {
+        pass = strideBase(sim) + STRIDE_ONE / ticketsOf(process);
+        if (process->process_pass < pass)
+            process->process_pass = pass;
+    }
+    if (sim->aging > 0)
+        process->process_pass = (process == sim->running) ? runningKey(sim) : agedKey(sim, process);
+    HeapPush(sim->ready, process);
+}
+
+/*!
+* Returns the number of processes in the ready queue.
+*
+* Receive param sim The simulator
+*
+* return Number of processes waiting for the CPU
+*/
+static int readySize(Simulator sim)
+{
+    if (sim->algorithm == LOTTERY)
+        return LotterySize(sim->lottery);
+    if (sim->algorithm == FAIR_SHARE)
+        return FairShareSize(sim->fair);
+    return HeapSize(sim->ready);
+}
+
+/*!
+* Takes the next process of the ready queue and gives it the CPU.
+*
+* Receive param sim The simulator
+*/
+static void dispatch(Simulator sim)
+{
+    Process process;
+    if (sim->algorithm == LOTTERY)
+        process = LotteryDraw(sim->lottery);
+    else if (sim->algorithm == FAIR_SHARE)
+        process = FairSharePick(sim->fair);
+    else
+        process = HeapPop(sim->ready);
+    if (sim->algorithm == STRIDE)
+    {
+        if (sim->sliceStart < sim->clock)
+            sim->lastPass = sim->globalPass;
+        sim->globalPass = process->process_pass;
+    }
+    process->process_lastruntime = sim->clock;
+    if (process->process_starttime < 0)
+        process->process_starttime = sim->clock;
+    sim->running = process;
+    sim->sliceStart = sim->clock;
+    logEvent(sim, "dispatch", process);
+}
+
+/*!
+* Tells if the head of the ready queue takes the CPU from the running process.
+*
+* Receive param sim The simulator
+*
+* return 1 if the running process must go back to the ready queue
+*
+* A process dispatched at the current time has not used the CPU yet, so
+  even without preemption a process that arrives at that same time and
+  goes before it takes its place, as if both had been there when the
+  CPU became free. Lottery and fair share never revise a decision.
+*/
+static int goesFirst(Simulator sim)
+{
+    Process head;
+    long long key; /* Aged priority key of the running process */
+    if (sim->algorithm == LOTTERY || sim->algorithm == FAIR_SHARE || HeapSize(sim->ready) == 0)
+        return 0;
+    if (!sim->preemptive && sim->sliceStart < sim->clock)
+        return 0;
+    head = HeapPeek(sim->ready);
+    if (sim->aging > 0)
+    {
+        key = runningKey(sim);
+        return head->process_pass < key || (head->process_pass == key && head->process_id < sim->running->process_id);
+    }
+    return sim->compare(head, sim->running) < 0;
+}
+
+/*!
+* Takes the decisions at the current time.
+*
+* Receive param sim The simulator
+*
+* The running process goes back to the ready queue if the head goes
+  before it. If the CPU is free the head runs.
+*/
+static void decide(Simulator sim)
+{
+    if (sim->running != NULL && goesFirst(sim))
+    {
+        logEvent(sim, "preempt", sim->running);
+        /* A process that has not run yet has not started */
+        if (sim->running->process_starttime == sim->clock && sim->running->process_runtime == 0)
+            sim->running->process_starttime = -1;
+        enqueue(sim, sim->running);
+        sim->running = NULL;
+    }
+    if (sim->running == NULL && readySize(sim) > 0)
+        dispatch(sim);
+}
+
+/*!
+* Accumulates the metrics of a finished process in the totals of its group
+* and of the groups above it.
+*
+* Receive param sim The simulator
+* Receive param process The process that just finished
+*
+* The totals are kept in a hash table, so any group id costs the same.
+*/
+static void addGroup(Simulator sim, Process process)
+{
+    struct group_stats_p *stats;
+    if (process->process_group > 0)
+        sim->grouped = 1;
+    for (stats = getGroup(sim, process->process_group); stats != NULL; stats = stats->parent)
+    {
+        stats->finished++;
+        stats->sumWait += sim->clock - process->process_arrival - process->process_burst - process->process_iotime;
+        stats->sumResponse += process->process_starttime - process->process_arrival;
+        stats->sumTurnaround += sim->clock - process->process_arrival;
+    }
+}
+
+/*!
+* Counts a process that becomes ready or stops being ready or running.
+*
+* Receive param sim The simulator
+* Receive param process The process
+* Receive param delta 1 when it becomes ready, -1 when it blocks or finishes
+*
+* The groups with processes ready or running are kept in a set, so
+  moving the clock only visits them.
+*/
+static void countRunnable(Simulator sim, Process process, int delta)
+{
+    struct group_stats_p *stats;
+    sim->runnable += delta;
+    for (stats = getGroup(sim, process->process_group); stats != NULL; stats = stats->parent)
+    {
+        stats->runnable += delta;
+        if (stats->runnable == 0)
+            g_hash_table_remove(sim->busy, stats);
+        else if (stats->runnable == 1 && delta > 0)
+            g_hash_table_insert(sim->busy, stats, stats);
+    }
+}
+
+/*!
+* Charges some time to the groups that are competing for the CPU.
+*
+* Receive param sim The simulator
+* Receive param used Time that passed
+*
+* A group competes while it has processes ready or running and some
+  process outside it does too. The share of a group is the CPU time
+  it receives while it competes divided by that time, so it shows how
+  each algorithm splits the CPU and not how much work the group had.
+*/
+static void chargeGroups(Simulator sim, int used)
+{
+    GHashTableIter iter;
+    gpointer key, value;
+    struct group_stats_p *stats;
+    /* A single group has no one to compete with */
+    if (g_hash_table_size(sim->busy) < 2)
+        return;
+    g_hash_table_iter_init(&iter, sim->busy);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+    {
+        stats = value;
+        if (stats->runnable < sim->runnable)
+            stats->contended += used;
+    }
+    if (sim->running == NULL)
+        return;
+    for (stats = getGroup(sim, sim->running->process_group); stats != NULL; stats = stats->parent)
+        if (stats->runnable < sim->runnable)
+            stats->share += used;
+}
+
+/*!
+* Accumulates the metrics of a finished process and frees it.
+*
+* Receive param sim The simulator
+* Receive param process The process that just finished
+*/
+static void retire(Simulator sim, Process process)
+{
+    double slowdown; /* Turnaround divided by burst */
+    logEvent(sim, "finish", process);
+    sim->finished++;
+    sim->sumWait += sim->clock - process->process_arrival - process->process_burst - process->process_iotime;
+    sim->sumResponse += process->process_starttime - process->process_arrival;
+    sim->sumTurnaround += sim->clock - process->process_arrival;
+    slowdown = (double)(sim->clock - process->process_arrival) / (process->process_burst > 0 ? process->process_burst : 1);
+    sim->sumSlowdown += slowdown;
+    sim->sumSlowdown2 += slowdown * slowdown;
+    sim->lastFinish = sim->clock;
+    if (process->process_deadline != NO_DEADLINE)
+    {
+        HistogramAdd(sim->lateness, sim->clock - process->process_deadline);
+        if (sim->clock > process->process_deadline)
+            sim->missed++;
+    }
+    addGroup(sim, process);
+    countRunnable(sim, process, -1);
+    if (sim->exporter != NULL)
+        ExportProcess(sim->exporter, sim->algorithm, process, sim->clock);
+    sim->active--;
+    freeNode(process);
+}
+
+/*!
+* Returns the time at which the running process leaves the CPU.
+*
+* Receive param sim The simulator
+*
+* return The time its CPU burst ends or its quantum expires
+*/
+static int nextEvent(Simulator sim)
+{
+    int end = sim->clock + sim->running->process_remainingcycles;
+    if (sim->quantum > 0 && sim->sliceStart + sim->quantum < end)
+        end = sim->sliceStart + sim->quantum;
+    return end;
+}
+
+/*!
+* Returns the time of the next event.
+*
+* Receive param sim The simulator
+*
+* return The earliest of the running process leaving the CPU and the
+*        next wake up bound of the timing wheel, -1 if there is none
+*/
+static int nextTime(Simulator sim)
+{
+    int end = (sim->running != NULL) ? nextEvent(sim) : -1;
+    int wake = WheelNext(sim->wheel);
+    if (end < 0 || (wake >= 0 && wake < end))
+        return wake;
+    return end;
+}
+
+/*!
+* Moves the clock, the running process uses the CPU in the meantime.
+*
+* Receive param sim The simulator
+* Receive param time New time
+*/
+static void elapse(Simulator sim, int time)
+{
+    if (sim->running != NULL)
+    {
+        sim->running->process_remainingcycles -= time - sim->clock;
+        sim->running->process_runtime += time - sim->clock;
+    }
+    if (time > sim->clock)
+        chargeGroups(sim, time - sim->clock);
+    sim->clock = time;
+}
+
+/*!
+* Takes the CPU away from the running process once its event arrives.
+*
+* Receive param sim The simulator
+*
+* A process that ended its last CPU burst is retired, one that has an
+  I/O burst next goes to the timing wheel and one whose quantum expired
+  goes back to the ready queue. Stride scheduling charges the process a
+  stride for every quantum of CPU it used and fair share scheduling
+  charges the time used to the process and its groups.
+*/
+static void release(Simulator sim)
+{
+    Process process = sim->running;
+    int used = sim->clock - sim->sliceStart;
+    int io;
+    sim->running = NULL;
+    if (sim->algorithm == STRIDE)
+        process->process_pass += (sim->quantum > 0) ? (long long)(STRIDE_ONE / ticketsOf(process)) * used / sim->quantum
+                                                    : STRIDE_ONE / ticketsOf(process);
+    if (sim->algorithm == FAIR_SHARE)
+        FairShareCharge(sim->fair, process, ticketsOf(process), used);
+    if (process->process_remainingcycles > 0)
+    {
+        /* The quantum expired, the process goes to the end of the queue */
+        logEvent(sim, "preempt", process);
+        enqueue(sim, process);
+    }
+    else if (process->process_phase + 1 < process->process_nbursts)
+    {
+        /* The process blocks for I/O and will need the next CPU burst */
+        io = process->process_bursts[process->process_phase + 1];
+        process->process_phase += 2;
+        process->process_remainingcycles = process->process_bursts[process->process_phase];
+        logEvent(sim, "block", process);
+        if (io > 0)
+        {
+            countRunnable(sim, process, -1);
+            WheelInsert(sim->wheel, process, sim->clock + io);
+        }
+        else
+            enqueue(sim, process);
+    }
+    else
+    {
+        retire(sim, process);
+    }
+}
+
+/*!
+* Moves the timing wheel to the current time and readies the processes
+* that wake up.
+*
+* Receive param sim The simulator
+*
+* Woken processes go through enqueue like any arrival, so every
+  algorithm readmits them with its own ready queue.
+*/
+static void wakeUp(Simulator sim)
+{
+    GList *woken = WheelAdvance(sim->wheel, sim->clock), *l;
+    for (l = woken; l != NULL; l = l->next)
+    {
+        logEvent(sim, "wake", l->data);
+        countRunnable(sim, l->data, 1);
+        enqueue(sim, l->data);
+    }
+    g_list_free(woken);
+}
+
+/*!
+* Moves the clock forward processing every event on the way.
+*
+* Receive param sim The simulator
+* Receive param time Time to move to
+*
+* The decisions are taken after every event, including the ones that
+  happen exactly at time.
+*/
+static void advance(Simulator sim, int time)
+{
+    int event;
+    if (time <= sim->clock)
+        return;
+    while ((event = nextTime(sim)) >= 0 && event <= time)
+    {
+        elapse(sim, event);
+        /* The running process leaves the CPU, then the I/O that ended is done */
+        if (sim->running != NULL && nextEvent(sim) == event)
+            release(sim);
+        wakeUp(sim);
+        reportMetrics(sim);
+        decide(sim);
+    }
+    elapse(sim, time);
+    wakeUp(sim);
+    decide(sim);
+    reportMetrics(sim);
+}
+
+/*!
+* Hands a process to the simulator at its arrival time.
+*
+* Receive param sim The simulator
+* Receive param process The process, the simulator takes ownership of it
+*
+* Processes must be given in arrival order. A process that arrives
+  earlier than the current time is admitted at the current time.
+*/
+void SimulatorArrive(Simulator sim, Process process)
+{
+    advance(sim, process->process_arrival);
+    /* A process with a list of bursts starts with the first one */
+    if (process->process_bursts != NULL)
+    {
+        process->process_phase = 0;
+        process->process_remainingcycles = process->process_bursts[0];
+    }
+    if (sim->firstArrival < 0)
+        sim->firstArrival = process->process_arrival;
+    sim->active++;
+    if (sim->active > sim->maxActive)
+        sim->maxActive = sim->active;
+    countRunnable(sim, process, 1);
+    enqueue(sim, process);
+    decide(sim);
+}
+
+/*!
+* Runs the simulation until every process has finished.
+*
+* Receive param sim The simulator
+*
+* No more processes will arrive, so a process with no burst left can
+  be retired by moving the clock one unit past it.
+*/
+void SimulatorFinish(Simulator sim)
+{
+    int event;
+    while (sim->running != NULL || WheelSize(sim->wheel) > 0)
+    {
+        event = nextTime(sim);
+        advance(sim, event > sim->clock ? event : sim->clock + 1);
+        decide(sim);
+    }
+}
+
+/*!
+* Compares the totals of two groups by id.
+*
+* Receive param a Pointer to the first group
+* Receive param b Pointer to the second group
+*
+* return a negative value if a has the lower id
+*/
+static gint compareGroups(gconstpointer a, gconstpointer b)
+{
+    const struct group_stats_p *aa = a;
+    const struct group_stats_p *bb = b;
+    return (aa->id > bb->id) - (aa->id < bb->id);
+}
+
+/*!
+* Prints the average times of the processes that finished.
+*
+* Receive param sim The simulator
+*
+* Besides the averages, the throughput (processes finished per unit of
+  time) and the Jain fairness index of the slowdowns are printed. The
+  index is 1 when every process was slowed down by the same factor.
+  When some processes have deadlines the ratio of them that missed it
+  and the percentiles of their lateness are printed too.
+*/
+void PrintSimulatorResults(Simulator sim)
+{
+    int span; /* Time between the first arrival and the last finish */
+    GList *groups = NULL, *l;
+    struct group_stats_p *stats;
+    /* Averages use 32-bit floats like PrintAverageWaitTime */
+    float n = sim->finished > 0 ? (float)sim->finished : 1.0f;
+    printf("Average wait time for %s Algorithm : %f\n", AlgorithmName(sim->algorithm), (float)sim->sumWait / n);
+    printf("Average response time for %s Algorithm : %f\n", AlgorithmName(sim->algorithm), (float)sim->sumResponse / n);
+    printf("Average turnaround time for %s Algorithm : %f\n", AlgorithmName(sim->algorithm), (float)sim->sumTurnaround / n);
+    span = sim->lastFinish - sim->firstArrival;
+    printf("Throughput for %s Algorithm : %f\n", AlgorithmName(sim->algorithm), span > 0 ? (float)sim->finished / span : 0.0f);
+    printf("Fairness index for %s Algorithm : %f\n", AlgorithmName(sim->algorithm),
+           sim->sumSlowdown2 > 0 ? (float)(sim->sumSlowdown * sim->sumSlowdown / (n * sim->sumSlowdown2)) : 1.0f);
+    if (HistogramCount(sim->lateness) > 0)
+    {
+        printf("Deadline miss ratio for %s Algorithm : %f\n", AlgorithmName(sim->algorithm),
+               (float)sim->missed / HistogramCount(sim->lateness));
+        printf("Lateness p50 p90 p99 max for %s Algorithm : %d %d %d %d\n", AlgorithmName(sim->algorithm),
+               HistogramPercentile(sim->lateness, 50), HistogramPercentile(sim->lateness, 90),
+               HistogramPercentile(sim->lateness, 99), HistogramMax(sim->lateness));
+    }
+    /* Processes with groups also get the share of the CPU and the averages of every group */
+    if (sim->grouped)
+        groups = g_list_sort(g_hash_table_get_values(sim->groups), compareGroups);
+    for (l = groups; l != NULL; l = l->next)
+    {
+        stats = l->data;
+        if (stats->finished == 0)
+            continue;
+        if (stats->contended > 0)
+            printf("Group %d share while competing for %s Algorithm : %f\n", stats->id,
+                   AlgorithmName(sim->algorithm), (float)stats->share / stats->contended);
+        printf("Group %d average wait response turnaround for %s Algorithm : %f %f %f\n", stats->id,
+               AlgorithmName(sim->algorithm), (float)stats->sumWait / stats->finished,
+               (float)stats->sumResponse / stats->finished, (float)stats->sumTurnaround / stats->finished);
+    }
+    g_list_free(groups);
+}
+
+/*!
+* Returns the averages of the processes finished so far.
+*
+* Receive param sim The simulator
+* Receive param wait Where the average wait time is stored
+* Receive param response Where the average response time is stored
+* Receive param turnaround Where the average turnaround time is stored
+*/
+void SimulatorAverages(Simulator sim, double *wait, double *response, double *turnaround)
+{
+    double n = sim->finished > 0 ? (double)sim->finished : 1.0;
+    *wait = sim->sumWait / n;
+    *response = sim->sumResponse / n;
+    *turnaround = sim->sumTurnaround / n;
+}
+
+/*!
+* Frees the memory of a simulator and of any process it still holds.
+*
+* Receive param sim The simulator
+*/
+void DestroySimulator(Simulator sim)
+{
+    if (sim->running != NULL)
+        freeNode(sim->running);
+    DestroyHeap(sim->ready, freeNode);
+    if (sim->lottery != NULL)
+        DestroyLottery(sim->lottery, freeNode);
+    if (sim->fair != NULL)
+        DestroyFairShare(sim->fair, freeNode);
+    g_hash_table_destroy(sim->busy);
+    g_hash_table_destroy(sim->groups);
+    DestroyTimerWheel(sim->wheel, freeNode);
+    DestroyHistogram(sim->lateness);
+    free(sim);
+}
+
+/*!
+* Runs several algorithms on the processes given by a source.
+*
+* Receive param source Function that returns the processes in arrival order
+* Receive param data Argument passed to source
+* Receive param algorithms Values of algorithm_type to run
+* Receive param count Number of algorithms
+* Receive param quantum Time slice for Round Robin, lottery and stride
+* Receive param seed Seed of the random numbers of lottery scheduling
+* Receive param aging Aging rate of the priority algorithms, 0 for none
+* Receive param exporter Where the results of every process go, can be NULL
+* Receive param groups Groups of fair share scheduling, can be NULL
+*
+* The source is read only once, every process is copied for each
+  algorithm as it arrives so the simulations advance together.
+*/
+void SimulateAll(ProcessSource source, gpointer data, int *algorithms, int count, int quantum, guint32 seed, int aging,
+                 Exporter exporter, GroupTable groups)
+{
+    Simulator sims[NUM_ALGORITHMS];
+    Process process;
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        sims[i] = CreateSimulator(algorithms[i], quantum);
+        SimulatorSetSeed(sims[i], seed);
+        SimulatorSetAging(sims[i], aging);
+        SimulatorSetExport(sims[i], exporter);
+        SimulatorSetGroups(sims[i], groups);
+    }
+    while ((process = source(data)) != NULL)
+    {
+        for (i = 0; i < count - 1; i++)
+            SimulatorArrive(sims[i], copyFunction(process, NULL));
+        SimulatorArrive(sims[count - 1], process);
+    }
+    for (i = 0; i < count; i++)
+    {
+        SimulatorFinish(sims[i]);
+        PrintSimulatorResults(sims[i]);
+        DestroySimulator(sims[i]);
+    }
+}
+
+/*!
+* Returns a copy of the next process of a list.
+*
+* Receive param data Pointer to the GList pointer, it is moved to the next node
+*
+* return A copy of the process or NULL at the end of the list
+*
+* Used as a ProcessSource for lists already sorted by arrival.
+*/
+Process NextFromList(gpointer data)
+{
+    GList **cursor = data;
+    Process process;
+    if (*cursor == NULL)
+        return NULL;
+    process = copyFunction((*cursor)->data, NULL);
+    *cursor = (*cursor)->next;
+    return process;
+}
+
+/*!
+* Schedules processes as they are read from a stream.
+*
+* Receive param in Stream with the processes, usually a pipe on stdin
+* Receive param out Stream where the decisions are written
+* Receive param algorithm Value of algorithm_type
+* Receive param report Time between metric reports, 0 to disable them
+* Receive param seed Seed of the random numbers of lottery scheduling
+* Receive param aging Aging rate of the priority algorithms, 0 for none
+* Receive param exporter Where the results of every process go, can be NULL
+* Receive param groups Groups of fair share scheduling, can be NULL
+*
+* The stream uses the same format as the process files: the quantum
+  followed by one process per line in arrival order. Every process is
+  scheduled as soon as its line is read and the output is flushed before
+  waiting for the next line, so the decisions at its arrival are printed
+  without waiting for the next one.
+*/
+void OnlineSchedule(FILE *in, FILE *out, int algorithm, int report, guint32 seed, int aging, Exporter exporter,
+                    GroupTable groups)
+{
+    int values[MAXVAL]; /* Values read in the line */
+    int quantum = 0;    /* Quantum value for round robin */
+    Process process;    /* Process read from the stream */
+    Simulator sim;
+
+    /* The first number in the stream is the quantum */
+    if (GetLine(in, values, MAXVAL) > 0)
+        quantum = values[0];
+    sim = CreateSimulator(algorithm, quantum);
+    SimulatorSetSeed(sim, seed);
+    SimulatorSetAging(sim, aging);
+    SimulatorSetExport(sim, exporter);
+    SimulatorSetGroups(sim, groups);
+    SimulatorSetLog(sim, out, report);
+    while ((process = ReadProcess(in)) != NULL)
+    {
+        SimulatorArrive(sim, process);
+        fflush(out);
+    }
+    SimulatorFinish(sim);
+    PrintSimulatorResults(sim);
+    DestroySimulator(sim);
+}
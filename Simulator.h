@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: Simulator.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the event driven dispatcher
+ *
+ * Notes:
+ *          Requires glib.h, stdio.h, Process.h, Export.h and FairShare.h to be
+ *          included first.
+ *
+ */
+
+/* We make a typedef to facilitate declaration of simulator_p structures */
+typedef struct simulator_p *Simulator;
+
+/* Function that hands processes in arrival order, NULL when there are no more */
+typedef Process (*ProcessSource)(gpointer data);
+
+/* Consult documentation or Simulator.c for more information. */
+int ParseAlgorithm(const char *name);
+
+char *AlgorithmName(int algorithm);
+
+Simulator CreateSimulator(int algorithm, int quantum);
+
+void SimulatorSetSeed(Simulator sim, guint32 seed);
+
+void SimulatorSetAging(Simulator sim, int rate);
+
+void SimulatorSetGroups(Simulator sim, GroupTable table);
+
+void SimulatorSetLog(Simulator sim, FILE *log, int report);
+
+void SimulatorSetExport(Simulator sim, Exporter exporter);
+
+void SimulatorArrive(Simulator sim, Process process);
+
+void SimulatorFinish(Simulator sim);
+
+void PrintSimulatorResults(Simulator sim);
+
+void SimulatorAverages(Simulator sim, double *wait, double *response, double *turnaround);
+
+void DestroySimulator(Simulator sim);
+
+void SimulateAll(ProcessSource source, gpointer data, int *algorithms, int count, int quantum, guint32 seed, int aging,
+                 Exporter exporter, GroupTable groups);
+
+Process NextFromList(gpointer data);
+
+void OnlineSchedule(FILE *in, FILE *out, int algorithm, int report, guint32 seed, int aging, Exporter exporter,
+                    GroupTable groups);
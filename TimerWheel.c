@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: TimerWheel.c
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Hierarchical timing wheel that wakes up the processes when
+ *          their I/O burst ends.
+ *
+ * References:
+ *          Hashed and hierarchical timing wheels (Varghese & Lauck).
+ *
+ * Error handling:
+ *          None
+ *
+ * Notes:
+ *          There are six levels of 64 slots. A process goes to the lowest
+ *          level where its wake time shares all the higher bits with the
+ *          current time of the wheel, in the slot given by the six bits of
+ *          that level. Inserting is O(1). When the time of the wheel enters
+ *          a slot of a higher level, the processes in it move down to the
+ *          lower levels; each process moves at most once per level, so a
+ *          wake up costs O(1). Every level keeps a 64 bit mask of the slots
+ *          in use, so the next wake up is found without looking at every
+ *          slot or every tick and the simulator can jump straight to it.
+ *
+ */
+#include <stdio.h>      /* Used for the FILE type in Process.h */
+#include <stdlib.h>     /* Used for memory manipulation */
+#include <glib.h>       /* Used for GList */
+#include "Process.h"    /* Used for the data structures */
+#include "TimerWheel.h" /* Function header */
+
+#define LEVELS 6     //!< Levels of the wheel, enough for 36 bits of time.
+#define SLOT_BITS 6  //!< Bits of time covered by every level.
+#define SLOTS 64     //!< Slots in every level.
+
+/* Declaration of the data structure timer_wheel_p with the slots of every level */
+struct timer_wheel_p
+{
+    GList *slots[LEVELS][SLOTS]; /* Processes waiting in every slot */
+    guint64 used[LEVELS];        /* Bit i is set if slot i has processes */
+    long long now;               /* Time of the wheel, every earlier wake up happened */
+    int size;                    /* Number of processes waiting */
+};
+
+/*!
+* Returns the slot of a level that holds a time.
+*
+* Receive param time The time
+* Receive param level The level
+*
+* return Index of the slot
+*/
+static int slotOf(long long time, int level)
+{
+    return (int)((time >> (SLOT_BITS * level)) & (SLOTS - 1));
+}
+
+/*!
+* Compares processes by ID.
+*
+* Receive param a Pointer to the first process
+* Receive param b Pointer to the second process
+*
+* return a negative value if a has the lower ID
+*/
+static gint compareID(gconstpointer a, gconstpointer b)
+{
+    const struct process_p *aa = a;
+    const struct process_p *bb = b;
+    return aa->process_id - bb->process_id;
+}
+
+/*!
+* Puts a process in the slot that corresponds to its wake time.
+*
+* Receive param wheel The wheel
+* Receive param process The process, process_wake holds its wake time
+*/
+static void place(TimerWheel wheel, Process process)
+{
+    long long wake = process->process_wake;
+    int level = 0, slot;
+    /* The level is the first one above which the times are equal */
+    while (level < LEVELS - 1 && (wake >> (SLOT_BITS * (level + 1))) != (wheel->now >> (SLOT_BITS * (level + 1))))
+        level++;
+    slot = slotOf(wake, level);
+    wheel->slots[level][slot] = g_list_prepend(wheel->slots[level][slot], process);
+    wheel->used[level] |= (guint64)1 << slot;
+}
+
+/*!
+* Moves the processes of a slot to the lower levels.
+*
+* Receive param wheel The wheel
+* Receive param level Level of the slot
+* Receive param slot Index of the slot
+*/
+static void cascade(TimerWheel wheel, int level, int slot)
+{
+    GList *list = wheel->slots[level][slot], *l;
+    wheel->slots[level][slot] = NULL;
+    wheel->used[level] &= ~((guint64)1 << slot);
+    for (l = list; l != NULL; l = l->next)
+        place(wheel, l->data);
+    g_list_free(list);
+}
+
+/*!
+* Creates an empty wheel.
+*
+* Receive param now Current time
+*
+* return Pointer to the new wheel
+*/
+TimerWheel CreateTimerWheel(int now)
+{
+    TimerWheel wheel = (TimerWheel)calloc(1, sizeof(struct timer_wheel_p));
+    wheel->now = now;
+    return wheel;
+}
+
+/*!
+* Adds a process that will wake up at a given time.
+*
+* Receive param wheel The wheel
+* Receive param process The process that starts an I/O burst
+* Receive param wake Time the I/O burst ends, after the time of the wheel
+*/
+void WheelInsert(TimerWheel wheel, Process process, int wake)
+{
+    process->process_wake = wake;
+    place(wheel, process);
+    wheel->size++;
+}
+
+/*!
+* Returns a time at or before the next wake up.
+*
+* Receive param wheel The wheel
+*
+* return -1 if the wheel is empty. If the next process is in the first
+*        level its exact wake time, otherwise the start of its slot; once
+*        the wheel is advanced to that time the next call is more precise.
+*/
+int WheelNext(TimerWheel wheel)
+{
+    guint64 mask;
+    int level, slot;
+    long long block;
+    if (wheel->size == 0)
+        return -1;
+    for (level = 0; level < LEVELS; level++)
+    {
+        /* Slots at or after the current one in the first level, after it in the rest */
+        slot = slotOf(wheel->now, level) + (level > 0);
+        mask = (slot < SLOTS) ? wheel->used[level] & (~(guint64)0 << slot) : 0;
+        if (mask != 0)
+        {
+            slot = __builtin_ctzll(mask);
+            block = wheel->now >> (SLOT_BITS * (level + 1)) << (SLOT_BITS * (level + 1));
+            return (int)(block | ((long long)slot << (SLOT_BITS * level)));
+        }
+    }
+    return -1;
+}
+
+/*!
+* Moves the wheel to a time and returns the processes that wake up then.
+*
+* Receive param wheel The wheel
+* Receive param time New time, not after the value of WheelNext
+*
+* return GList with the processes whose wake time is time in ID order,
+*        to be freed with g_list_free
+*
+* The slots entered on the way, from the highest level down, are moved
+  to the lower levels.
+*/
+GList *WheelAdvance(TimerWheel wheel, int time)
+{
+    long long old = wheel->now;
+    GList *woken;
+    int level, slot;
+    if (time < old)
+        return NULL;
+    wheel->now = time;
+    for (level = LEVELS - 1; level > 0; level--)
+    {
+        if ((old >> (SLOT_BITS * level)) != ((long long)time >> (SLOT_BITS * level)))
+        {
+            slot = slotOf(time, level);
+            if (wheel->used[level] & ((guint64)1 << slot))
+                cascade(wheel, level, slot);
+        }
+    }
+    slot = slotOf(time, 0);
+    woken = wheel->slots[0][slot];
+    if (woken == NULL)
+        return NULL;
+    wheel->slots[0][slot] = NULL;
+    wheel->used[0] &= ~((guint64)1 << slot);
+    wheel->size -= g_list_length(woken);
+    /* Processes that wake up at the same time are returned in ID order */
+    return g_list_sort(woken, compareID);
+}
+
+/*!
+* Returns the number of processes waiting.
+*
+* Receive param wheel The wheel
+*
+* return Number of processes in the wheel
+*/
+int WheelSize(TimerWheel wheel)
+{
+    return wheel->size;
+}
+
+/*!
+* Frees the memory of a wheel.
+*
+* Receive param wheel The wheel to destroy
+* Receive param free_func Function applied to every process left, can be NULL
+*/
+void DestroyTimerWheel(TimerWheel wheel, GDestroyNotify free_func)
+{
+    int level, slot;
+    for (level = 0; level < LEVELS; level++)
+        for (slot = 0; slot < SLOTS; slot++)
+            if (free_func != NULL)
+                g_list_free_full(wheel->slots[level][slot], free_func);
+            else
+                g_list_free(wheel->slots[level][slot]);
+    free(wheel);
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2017 Xavier Guinto & Gustavo Santamaria
+ *
+ * File name: TimerWheel.h
+ *
+ * Author:  Xavier Guinto & Gustavo Santamaria
+ *
+ * Purpose: Header file for the timing wheel that holds the processes
+ *          waiting for I/O
+ *
+ * Notes:
+ *          Requires glib.h, stdio.h and Process.h to be included first.
+ *
+ */
+
+/* We make a typedef to facilitate declaration of timer_wheel_p structures */
+typedef struct timer_wheel_p *TimerWheel;
+
+/* Consult documentation or TimerWheel.c for more information. */
+TimerWheel CreateTimerWheel(int now);
+
+void WheelInsert(TimerWheel wheel, Process process, int wake);
+
+int WheelNext(TimerWheel wheel);
+
+GList *WheelAdvance(TimerWheel wheel, int time);
+
+int WheelSize(TimerWheel wheel);
+
+void DestroyTimerWheel(TimerWheel wheel, GDestroyNotify free_func);